@@ -0,0 +1,1030 @@
+/*
+	ofxNDI benchmark
+
+	Measures the pixel and audio functions of ofxNDIutils
+	for each SIMD level supported by the CPU, or verifies
+	each SIMD level against the scalar functions.
+
+	Openframeworks and the NDI runtime are not required.
+	Build from this folder with :
+
+	  g++ -std=c++17 -O2 -I../src ofxNDIbenchmark.cpp ../src/ofxNDIutils.cpp -lpthread -o ofxNDIbenchmark
+
+	Visual Studio developer command prompt :
+
+	  cl /O2 /EHsc /std:c++17 /I..\src ofxNDIbenchmark.cpp ..\src\ofxNDIutils.cpp
+
+	Options :
+
+	  --json [file]     JSON output to the console or a file
+	  --size name       720p, 1080p, 2160p or 4320p (repeat for more than one)
+	  --kernel name     Function name as listed (repeat for more than one)
+	  --threads n       Conversion threads (0 for all cores, default 1)
+	  --time msec       Minimum measurement time for each test (default 250)
+
+	Each test is repeated for the minimum time and the median is reported.
+	GB/s is for bytes read and written. "padded" tests add 64 pixels
+	to each source and destination line.
+
+	Verify :
+
+	  --verify [count]  Compare each SIMD level with the scalar functions
+	                    for count random tests (default 1000)
+	  --seed n          Random seed to repeat a test sequence (default 1)
+
+	Returns 1 if any test fails. --kernel and --threads also apply.
+
+	Copyright (C) 2026 Lynn Jarvis.
+
+	http://www.spout.zeal.co
+
+	=========================================================================
+	This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+	=========================================================================
+
+	17.10.26 - Create file
+			 - Add --verify for SIMD and scalar comparison
+			 - Verify conversion during static initialization
+			 - Verify conversion with the thread count changed between frames
+			 - Verify alpha conversion in the conversion and scaling pass
+			   with the lookup table after unpremultiply or before premultiply
+			 - Add RGB_to_YUV422
+
+*/
+#include "ofxNDIutils.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+// Frame sizes tested
+struct benchsize {
+	const char* name;
+	unsigned int width;
+	unsigned int height;
+};
+
+static const benchsize sizes[] = {
+	{ "720p",  1280,  720 },
+	{ "1080p", 1920, 1080 },
+	{ "2160p", 3840, 2160 },
+	{ "4320p", 7680, 4320 },
+};
+
+// Result of one test
+struct benchresult {
+	std::string kernel;
+	std::string size;
+	std::string level;
+	std::string unit;  // pixel, sample or frame
+	bool bPadded;
+	unsigned int iterations;
+	double units;      // pixels, samples or frames for each call
+	double bytes;      // bytes read and written for each call
+	double msec;       // median time for each call
+};
+
+// Command line options
+static std::vector<std::string> sizefilter;
+static std::vector<std::string> kernelfilter;
+static double mintime = 250.0; // msec
+
+// Table output. stderr if JSON is written to the console.
+static FILE* console = stdout;
+
+// SIMD levels tested if supported by the CPU
+static const ofxNDIsimd levels[] = { simd_none, simd_sse2, simd_ssse3, simd_avx2, simd_neon };
+
+static const char* LevelName(ofxNDIsimd level)
+{
+	switch (level) {
+		case simd_sse2:  return "sse2";
+		case simd_ssse3: return "ssse3";
+		case simd_avx2:  return "avx2";
+		case simd_neon:  return "neon";
+		default:         return "scalar";
+	}
+}
+
+static bool Selected(const std::vector<std::string>& filter, const char* name)
+{
+	if (filter.empty())
+		return true;
+	return std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
+// Repeat a function for the minimum time and return the median msec
+template<typename F>
+static double Measure(F func, unsigned int &iterations)
+{
+	func(); // Warm up caches and threads
+
+	std::vector<double> times;
+	double total = 0.0;
+	while ((total < mintime || times.size() < 5) && times.size() < 10000) {
+		auto start = std::chrono::steady_clock::now();
+		func();
+		auto end = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+		times.push_back(elapsed);
+		total += elapsed;
+	}
+	iterations = (unsigned int)times.size();
+	std::nth_element(times.begin(), times.begin() + times.size()/2, times.end());
+	return times[times.size()/2];
+}
+
+template<typename F>
+static void Run(std::vector<benchresult> &results, const char* kernel, const char* size, ofxNDIsimd level,
+	bool bPadded, const char* unit, double units, double bytes, F func)
+{
+	if (!Selected(kernelfilter, kernel))
+		return;
+
+	benchresult r;
+	r.kernel = kernel;
+	r.size = size;
+	r.level = LevelName(level);
+	r.unit = unit;
+	r.bPadded = bPadded;
+	r.units = units;
+	r.bytes = bytes;
+	r.msec = Measure(func, r.iterations);
+	results.push_back(r);
+
+	fprintf(console, "%-22s %-7s %-7s %-6s %9.3f ms %8.2f GB/s %8.3f ns/%s\n",
+		kernel, size, bPadded ? "padded" : "", r.level.c_str(), r.msec,
+		bytes > 0.0 ? bytes/(r.msec*1e6) : 0.0, r.msec*1e6/units, unit);
+}
+
+// FourCC code of an NDI video frame type
+static uint32_t FourCC(char a, char b, char c, char d)
+{
+	return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+}
+
+// Lookup table with random 3D points of "size" on each axis (0 for none)
+// and option random 1D tables
+static ofxNDIlut RandomLUT(uint32_t seed, unsigned int size, bool b1D)
+{
+	ofxNDIlut lut;
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> value(-0.1f, 1.1f); // clamped
+	if (b1D) {
+		std::vector<float> table(17*3);
+		for (float &v : table) v = value(rng);
+		ofxNDIutils::CreateLUT1D(lut, table.data(), 17);
+	}
+	if (size > 0) {
+		std::vector<float> points((size_t)size*size*size*3);
+		for (float &v : points) v = value(rng);
+		ofxNDIutils::CreateLUT3D(lut, points.data(), size);
+	}
+	return lut;
+}
+
+// Random tensor normalization
+// A small std for some tests gives float16 overflow to inf
+static ofxNDItensor RandomTensor(uint32_t seed, bool bHalf)
+{
+	ofxNDItensor tensor;
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> value(0.0f, 1.0f);
+	for (unsigned int c = 0; c < 3; c++) {
+		tensor.mean[c] = value(rng);
+		tensor.std[c] = (rng() % 8 == 0) ? 1e-5f : 0.05f + value(rng);
+	}
+	tensor.bHalf = bHalf;
+	tensor.bBGR = (rng() & 1) != 0;
+	return tensor;
+}
+
+// Pixel functions for one frame size at the current SIMD level
+static void RunPixels(std::vector<benchresult> &results, const benchsize &sz, ofxNDIsimd level)
+{
+	const unsigned int w = sz.width;
+	const unsigned int h = sz.height;
+	const double pixels = (double)w*h;
+
+	// Padded line pitch adds 64 pixels
+	const unsigned int pad = 64;
+	const unsigned int rgbaPitch = (w + pad)*4;
+	const unsigned int uyvyPitch = (w + pad)*2;
+
+	std::vector<unsigned char> src((size_t)rgbaPitch*h);
+	std::vector<unsigned char> dst((size_t)rgbaPitch*h);
+	for (size_t i = 0; i < src.size(); i++)
+		src[i] = (unsigned char)(i*7 + (i >> 11));
+
+	const unsigned char* s = src.data();
+	unsigned char* d = dst.data();
+
+	Run(results, "CopyImage", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage(s, d, w, h); });
+
+	Run(results, "CopyImage_stride", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage(s, d, w, h, w*4, false, false); });
+
+	Run(results, "CopyImage_stride", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, false, false); });
+
+	Run(results, "CopyImage_pitch", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage((const void*)s, (void*)d, w, h, w*4, w*4); });
+
+	Run(results, "CopyImage_pitch", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage((const void*)s, (void*)d, w, h, rgbaPitch, rgbaPitch); });
+
+	Run(results, "CopyImage_pitch_swap", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::CopyImage((const void*)s, (void*)d, w, h, rgbaPitch, rgbaPitch, false, true); });
+
+	Run(results, "rgba_bgra", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::rgba_bgra(s, d, w, h); });
+
+	Run(results, "rgba_bgra", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::rgba_bgra(s, d, w, h, false, rgbaPitch, rgbaPitch); });
+
+	Run(results, "FlipBuffer", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::FlipBuffer(s, d, w, h); });
+
+	Run(results, "FlipBuffer", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::FlipBuffer(s, d, w, h, rgbaPitch, rgbaPitch); });
+
+	Run(results, "FlipVertical", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::FlipVertical(d, w, h); });
+
+	Run(results, "FlipVertical", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::FlipVertical(d, w, h, rgbaPitch); });
+
+	Run(results, "PremultiplyAlpha", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::PremultiplyAlpha(s, d, w, h); });
+
+	Run(results, "PremultiplyAlpha_swap", sz.name, level, true, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::PremultiplyAlpha(s, d, w, h, rgbaPitch, rgbaPitch, false, true); });
+
+	Run(results, "UnpremultiplyAlpha", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::UnpremultiplyAlpha(s, d, w, h); });
+
+	// 33 point grading cube, per channel gamma tables
+	const ofxNDIlut cube = RandomLUT(1, 33, false);
+	const ofxNDIlut gamma = RandomLUT(1, 0, true);
+
+	Run(results, "ApplyLUT_3D", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::ApplyLUT(cube, s, d, w, h); });
+
+	Run(results, "ApplyLUT_1D", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::ApplyLUT(gamma, s, d, w, h); });
+
+	Run(results, "rgb2rgba", sz.name, level, false, "pixel", pixels, pixels*7,
+		[&]() { ofxNDIutils::rgb2rgba(s, d, w, h, false); });
+
+	Run(results, "RGB_to_YUV422", sz.name, level, false, "pixel", pixels, pixels*5,
+		[&]() { ofxNDIutils::RGB_to_YUV422(s, d, w, h); });
+
+	// ImageNet normalization
+	ofxNDItensor tensor;
+	const float mean[3] = { 0.485f, 0.456f, 0.406f };
+	const float stddev[3] = { 0.229f, 0.224f, 0.225f };
+	std::copy(mean, mean + 3, tensor.mean);
+	std::copy(stddev, stddev + 3, tensor.std);
+	std::vector<float> planes((size_t)w*h*3);
+	void* t = planes.data();
+
+	Run(results, "RGBA_to_Tensor", sz.name, level, false, "pixel", pixels, pixels*16,
+		[&]() { ofxNDIutils::RGBA_to_Tensor(s, t, w, h, 0, true, tensor); });
+
+	Run(results, "YUV422_to_Tensor", sz.name, level, false, "pixel", pixels, pixels*14,
+		[&]() { ofxNDIutils::YUV422_to_Tensor(s, t, w, h, 0, tensor); });
+
+	tensor.bHalf = true;
+	Run(results, "RGBA_to_Tensor_half", sz.name, level, false, "pixel", pixels, pixels*10,
+		[&]() { ofxNDIutils::RGBA_to_Tensor(s, t, w, h, 0, true, tensor); });
+
+	Run(results, "YUV422_to_Tensor_half", sz.name, level, false, "pixel", pixels, pixels*8,
+		[&]() { ofxNDIutils::YUV422_to_Tensor(s, t, w, h, 0, tensor); });
+
+	// Line hashes for change detection
+	std::vector<uint64_t> hashes(h);
+	Run(results, "HashLines", sz.name, level, false, "pixel", pixels, pixels*4,
+		[&]() { ofxNDIutils::HashLines(s, w*4, h, 0, hashes.data()); });
+
+	Run(results, "HashLines", sz.name, level, true, "pixel", pixels, pixels*4,
+		[&]() { ofxNDIutils::HashLines(s, w*4, h, rgbaPitch, hashes.data()); });
+
+	Run(results, "rgb2rgba", sz.name, level, true, "pixel", pixels, pixels*7,
+		[&]() { ofxNDIutils::rgb2rgba(s, d, w, h, false, (w + pad)*3, rgbaPitch); });
+
+	Run(results, "rgb2rgba_swap", sz.name, level, false, "pixel", pixels, pixels*7,
+		[&]() { ofxNDIutils::rgb2rgba(s, d, w, h, false, 0, 0, true); });
+
+	Run(results, "YUV422_to_RGBA", sz.name, level, false, "pixel", pixels, pixels*6,
+		[&]() { ofxNDIutils::YUV422_to_RGBA(s, d, w, h); });
+
+	Run(results, "YUV422_to_RGBA", sz.name, level, true, "pixel", pixels, pixels*6,
+		[&]() { ofxNDIutils::YUV422_to_RGBA(s, d, w, h, uyvyPitch, false, false, rgbaPitch); });
+
+	// Multiviewer tiles - quarter size box filter and bilinear to 30%
+	Run(results, "YUV422_to_RGBA_scaled_box", sz.name, level, false, "pixel", pixels, pixels*2 + pixels/4,
+		[&]() { ofxNDIutils::YUV422_to_RGBA_scaled(s, d, w, h, 0, w/4, h/4); });
+
+	Run(results, "YUV422_to_RGBA_scaled_bilinear", sz.name, level, false, "pixel", pixels, pixels*2 + pixels*9/25,
+		[&]() { ofxNDIutils::YUV422_to_RGBA_scaled(s, d, w, h, 0, w*3/10, h*3/10); });
+
+	Run(results, "ScaleImage_box", sz.name, level, false, "pixel", pixels, pixels*4 + pixels/4,
+		[&]() { ofxNDIutils::ScaleImage(s, d, w, h, 0, w/4, h/4, false, true); });
+
+	Run(results, "ScaleImage_bilinear", sz.name, level, false, "pixel", pixels, pixels*4 + pixels*9/25,
+		[&]() { ofxNDIutils::ScaleImage(s, d, w, h, 0, w*3/10, h*3/10, false, true); });
+
+	// Lower third of the frame and a quarter panel at an odd column
+	Run(results, "ConvertRegion_UYVY", sz.name, level, false, "pixel", pixels/3, pixels*2,
+		[&]() { ofxNDIutils::ConvertRegion(s, FourCC('U', 'Y', 'V', 'Y'), w, h, 0, d, 0, h - h/3, w, h/3); });
+
+	Run(results, "ConvertRegion_NV12", sz.name, level, false, "pixel", pixels/4, pixels*11/8,
+		[&]() { ofxNDIutils::ConvertRegion(s, FourCC('N', 'V', '1', '2'), w, h, 0, d, w/2 + 1, h/2, w/2 - 1, h/2); });
+
+	// Whole frame graded in the conversion pass
+	Run(results, "ConvertRegion_UYVY_lut", sz.name, level, false, "pixel", pixels, pixels*6,
+		[&]() { ofxNDIutils::ConvertRegion(s, FourCC('U', 'Y', 'V', 'Y'), w, h, 0, d, 0, 0, w, h,
+			false, 0, matrix_auto, range_limited, false, &cube); });
+}
+
+// Audio functions are scalar and independent of frame size
+static void RunAudio(std::vector<benchresult> &results)
+{
+	// One 60 fps video frame of 48kHz audio for 2 and 8 channels
+	const int nSamples = 800;
+	for (int nChannels : { 2, 8 }) {
+		std::vector<float> interleaved((size_t)nSamples*nChannels);
+		for (size_t i = 0; i < interleaved.size(); i++)
+			interleaved[i] = (float)(i % 97)/97.0f;
+		const std::string name = std::to_string(nChannels) + "ch";
+		const double samples = (double)nSamples*nChannels;
+		Run(results, "InterleavedToPlanar", name.c_str(), simd_none, false, "sample", samples, samples*8,
+			[&]() { ofxNDIutils::InterleavedToPlanar(interleaved.data(), nChannels, nSamples); });
+	}
+
+	// Sequence of 100 video frames at 29.97 fps
+	int maxSample = 0;
+	Run(results, "AudioFrameSequence", "29.97", simd_none, false, "frame", 100.0, 0.0,
+		[&]() { ofxNDIutils::AudioFrameSequence(48000, 30000.0/1001.0, maxSample, 100); });
+}
+
+static void WriteJson(FILE* file, const std::vector<benchresult> &results)
+{
+	fprintf(file, "{\n");
+	fprintf(file, "  \"version\": \"%s\",\n", ofxNDIutils::GetVersion().c_str());
+	fprintf(file, "  \"simd_support\": \"%s\",\n", LevelName(ofxNDIutils::GetSIMDsupport()));
+	fprintf(file, "  \"threads\": %u,\n", ofxNDIutils::GetThreadCount());
+	fprintf(file, "  \"results\": [\n");
+	for (size_t i = 0; i < results.size(); i++) {
+		const benchresult &r = results[i];
+		fprintf(file, "    { \"kernel\": \"%s\", \"size\": \"%s\", \"padded\": %s, \"level\": \"%s\", "
+			"\"iterations\": %u, \"ms\": %.4f, \"gbps\": %.3f, \"unit\": \"%s\", \"ns_per_unit\": %.4f }%s\n",
+			r.kernel.c_str(), r.size.c_str(), r.bPadded ? "true" : "false", r.level.c_str(),
+			r.iterations, r.msec, r.bytes > 0.0 ? r.bytes/(r.msec*1e6) : 0.0,
+			r.unit.c_str(), r.msec*1e6/r.units, i+1 < results.size() ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+}
+
+//
+// Verify
+//
+// Each SIMD level is compared with the scalar functions
+// for random sizes, line pitches, alignments and options.
+// The scalar reference is single threaded.
+// All functions are expected to match exactly.
+// Whole destination buffers are compared including line padding
+// and guard bytes, so writes outside the image are also detected.
+//
+
+// Random test parameters
+struct verifyparams {
+	unsigned int width;
+	unsigned int height;
+	unsigned int pad;       // extra bytes for each source line pitch
+	unsigned int dstpad;    // extra bytes for each destination line pitch
+	unsigned int srcoffset; // source and destination alignment
+	unsigned int dstoffset;
+	bool bInvert;
+	bool bSwapRB;
+	bool bOption;           // YV12, alpha or dither
+	ofxNDIcolormatrix matrix;
+	ofxNDIcolorrange range;
+	uint32_t seed;
+};
+
+struct verifycount {
+	std::string kernel;
+	unsigned int tests;
+	unsigned int failures;
+};
+
+static std::vector<verifycount> verifycounts;
+static const unsigned int guardbytes = 64;
+static const unsigned char guardvalue = 0xCD;
+
+// Conversion during static initialization of this file,
+// which may be before that of ofxNDIutils.cpp
+static bool StaticConversion()
+{
+	unsigned char source[4*4*4];
+	unsigned char dest[4*4*4];
+	for (unsigned int i = 0; i < sizeof(source); i++)
+		source[i] = (unsigned char)i;
+	ofxNDIutils::CopyImage((const void*)source, (void*)dest, 4, 4, 16, 16, true, true);
+	for (unsigned int y = 0; y < 4; y++) {
+		for (unsigned int x = 0; x < 4; x++) {
+			const unsigned char* s = source + (3-y)*16 + x*4;
+			const unsigned char* d = dest + y*16 + x*4;
+			if (d[0] != s[2] || d[1] != s[1] || d[2] != s[0] || d[3] != s[3])
+				return false;
+		}
+	}
+	return true;
+}
+static const bool bStaticConversion = StaticConversion();
+
+static void CountResult(const char* kernel, bool bPassed)
+{
+	for (verifycount &v : verifycounts) {
+		if (v.kernel == kernel) {
+			v.tests++;
+			if (!bPassed) v.failures++;
+			return;
+		}
+	}
+	verifycounts.push_back({ kernel, 1, bPassed ? 0u : 1u });
+}
+
+static void PrintFailure(const char* kernel, const char* level, const verifyparams &p, const char* reason, size_t index)
+{
+	unsigned int nFailures = 0;
+	for (const verifycount &v : verifycounts) nFailures += v.failures;
+	if (nFailures > 20)
+		return;
+	printf("FAILED %s %s - %s at byte %zu : %ux%u pad %u/%u offset %u/%u invert %d swap %d option %d matrix %d range %d seed %u\n",
+		kernel, level, reason, index, p.width, p.height, p.pad, p.dstpad, p.srcoffset, p.dstoffset,
+		(int)p.bInvert, (int)p.bSwapRB, (int)p.bOption, (int)p.matrix, (int)p.range, p.seed);
+}
+
+// Run a function for the scalar reference and each SIMD level.
+// func(source, dest) with buffers of srcsize and dstsize bytes.
+template<typename F>
+static void Check(const char* kernel, const verifyparams &p, size_t srcsize, size_t dstsize, F func)
+{
+	if (!Selected(kernelfilter, kernel))
+		return;
+
+	std::vector<unsigned char> src(srcsize + p.srcoffset);
+	std::mt19937 rng(p.seed);
+	for (unsigned char &b : src)
+		b = (unsigned char)rng();
+
+	const size_t total = p.dstoffset + dstsize + guardbytes;
+	std::vector<unsigned char> ref(total, guardvalue);
+	std::vector<unsigned char> dst(total);
+
+	const unsigned int nThreads = ofxNDIutils::GetThreadCount();
+	ofxNDIutils::SetThreadCount(1);
+	ofxNDIutils::SetSIMDlevel(simd_none);
+	func(src.data() + p.srcoffset, ref.data() + p.dstoffset);
+	ofxNDIutils::SetThreadCount(nThreads);
+
+	bool bPassed = true;
+	for (size_t i = 0; i < total; i++) {
+		if ((i < p.dstoffset || i >= p.dstoffset + dstsize) && ref[i] != guardvalue) {
+			PrintFailure(kernel, "scalar", p, "write outside the buffer", i);
+			bPassed = false;
+			break;
+		}
+	}
+
+	for (ofxNDIsimd level : levels) {
+		if (level == simd_none || ofxNDIutils::SetSIMDlevel(level) != level)
+			continue;
+		std::fill(dst.begin(), dst.end(), guardvalue);
+		func(src.data() + p.srcoffset, dst.data() + p.dstoffset);
+		auto diff = std::mismatch(ref.begin(), ref.end(), dst.begin());
+		if (diff.first != ref.end()) {
+			PrintFailure(kernel, LevelName(level), p, "differs from scalar",
+				(size_t)(diff.first - ref.begin()));
+			bPassed = false;
+		}
+	}
+	CountResult(kernel, bPassed);
+}
+
+// ConvertRegion for each SIMD level, then compared with
+// the same rectangle of the whole frame converted by "frame(source, dest)"
+// and the lookup table and alpha mode if used. The table grades
+// straight colour, after unpremultiply or before premultiply.
+template<typename F>
+static void CheckRegion(const char* kernel, const verifyparams &p, uint32_t fourcc, size_t srcsize,
+	unsigned int stride, bool bDither, F frame, const ofxNDIlut* lut = nullptr, ofxNDIalphamode alpha = alpha_none)
+{
+	if (!Selected(kernelfilter, kernel))
+		return;
+
+	const unsigned int w = p.width;
+	const unsigned int h = p.height;
+	const unsigned int x = p.seed % w;
+	const unsigned int y = (p.seed >> 8) % h;
+	const unsigned int rw = 1 + (p.seed >> 12) % (w - x);
+	const unsigned int rh = 1 + (p.seed >> 24) % (h - y);
+	const unsigned int regionPitch = rw*4 + p.dstpad;
+
+	Check(kernel, p, srcsize, (size_t)regionPitch*rh,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::ConvertRegion(s, fourcc, w, h, stride, d, x, y, rw, rh,
+				p.bInvert, regionPitch, p.matrix, p.range, bDither, lut, alpha); });
+
+	std::vector<unsigned char> src(srcsize);
+	std::mt19937 rng(p.seed);
+	for (unsigned char &b : src)
+		b = (unsigned char)rng();
+	std::vector<unsigned char> whole((size_t)w*h*4);
+	std::vector<unsigned char> region((size_t)regionPitch*rh);
+	frame(src.data(), whole.data());
+	if (alpha == alpha_unpremultiply)
+		ofxNDIutils::UnpremultiplyAlpha(whole.data(), whole.data(), w, h);
+	if (lut)
+		ofxNDIutils::ApplyLUT(*lut, whole.data(), whole.data(), w, h);
+	if (alpha == alpha_premultiply)
+		ofxNDIutils::PremultiplyAlpha(whole.data(), whole.data(), w, h);
+	ofxNDIutils::ConvertRegion(src.data(), fourcc, w, h, stride, region.data(), x, y, rw, rh,
+		p.bInvert, regionPitch, p.matrix, p.range, bDither, lut, alpha);
+
+	const std::string cropname = std::string(kernel) + "_crop";
+	for (unsigned int r = 0; r < rh; r++) {
+		const unsigned char* a = whole.data() + ((size_t)(y + r)*w + x)*4;
+		const unsigned char* b = region.data() + (size_t)(p.bInvert ? rh - 1 - r : r)*regionPitch;
+		if (memcmp(a, b, (size_t)rw*4) != 0) {
+			PrintFailure(cropname.c_str(), LevelName(ofxNDIutils::GetSIMDlevel()), p,
+				"differs from the whole frame", (size_t)r*regionPitch);
+			CountResult(cropname.c_str(), false);
+			return;
+		}
+	}
+	CountResult(cropname.c_str(), true);
+}
+
+static verifyparams RandomParams(std::mt19937 &rng)
+{
+	verifyparams p;
+	// Mostly small images, some wider than the 4:2:0 line buffer
+	p.width     = (rng() % 8 == 0) ? 1 + rng() % 2200 : 1 + rng() % 160;
+	p.height    = 1 + rng() % 24;
+	p.pad       = (rng() % 3 == 0) ? 0 : rng() % 72;
+	p.dstpad    = (rng() % 3 == 0) ? 0 : rng() % 72;
+	p.srcoffset = rng() % 64;
+	p.dstoffset = rng() % 64;
+	p.bInvert   = (rng() & 1) != 0;
+	p.bSwapRB   = (rng() & 1) != 0;
+	p.bOption   = (rng() & 1) != 0;
+	p.matrix    = (ofxNDIcolormatrix)((int)(rng() % 4) - 1);
+	p.range     = (ofxNDIcolorrange)(rng() % 2);
+	p.seed      = rng();
+	return p;
+}
+
+static void VerifyParams(const verifyparams &p)
+{
+	const unsigned int w = p.width;
+	const unsigned int h = p.height;
+	const bool bInvert = p.bInvert;
+	const bool bSwapRB = p.bSwapRB;
+	const bool bOption = p.bOption;
+	const ofxNDIcolormatrix matrix = p.matrix;
+	const ofxNDIcolorrange range = p.range;
+
+	// Source and destination line pitch with independent padding
+	const unsigned int rgbaPitch  = w*4 + p.pad;
+	const unsigned int rgbaDest   = w*4 + p.dstpad;
+	const unsigned int rgbPitch   = w*3 + p.pad;
+	const unsigned int uyvyPitch  = ((w+1)/2)*4 + (p.pad & ~3u);
+	const unsigned int uyvyDest   = ((w+1)/2)*4 + (p.dstpad & ~3u);
+	const size_t rgbasize = (size_t)w*4*h;
+	const size_t rgbaDestSize = (size_t)rgbaDest*h;
+
+	//
+	// RGBA
+	//
+	Check("CopyImage", p, rgbasize, rgbasize,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, bInvert); });
+
+	Check("CopyImage_stride", p, (size_t)rgbaPitch*h, rgbasize,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, bInvert); });
+
+	Check("CopyImage_pitch", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::CopyImage((const void*)s, (void*)d, w, h, rgbaPitch, rgbaDest, bInvert, bSwapRB); });
+
+	Check("rgba_bgra", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::rgba_bgra(s, d, w, h, bInvert, rgbaPitch, rgbaDest); });
+
+	Check("FlipBuffer", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::FlipBuffer(s, d, w, h, rgbaPitch, rgbaDest); });
+
+	// In place. Padding bytes are copied with the lines and must not move.
+	Check("FlipVertical", p, (size_t)rgbaPitch*h, (size_t)rgbaPitch*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			memcpy(d, s, (size_t)rgbaPitch*h);
+			ofxNDIutils::FlipVertical(d, w, h, rgbaPitch); });
+
+	Check("PremultiplyAlpha", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::PremultiplyAlpha(s, d, w, h, rgbaPitch, rgbaDest, bInvert, bSwapRB); });
+
+	Check("UnpremultiplyAlpha", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::UnpremultiplyAlpha(s, d, w, h, rgbaPitch, rgbaDest, bInvert, bSwapRB); });
+
+	// In place
+	Check("UnpremultiplyAlpha_inplace", p, (size_t)rgbaPitch*h, (size_t)rgbaPitch*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			memcpy(d, s, (size_t)rgbaPitch*h);
+			ofxNDIutils::UnpremultiplyAlpha(d, d, w, h, rgbaPitch, rgbaPitch, false, bSwapRB); });
+
+	// Random cube of 2 to 33 points, 1D tables as well for some
+	const ofxNDIlut lut = RandomLUT(p.seed, 2 + p.seed % 32, bOption);
+	Check("ApplyLUT", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::ApplyLUT(lut, s, d, w, h, rgbaPitch, rgbaDest, bInvert); });
+
+	Check("rgb2rgba", p, (size_t)rgbPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::rgb2rgba(s, d, w, h, bInvert, rgbPitch, rgbaDest, bSwapRB); });
+
+	// float planes aligned to 4 bytes
+	verifyparams pT = p;
+	pT.dstoffset &= ~3u;
+	const ofxNDItensor tensor = RandomTensor(p.seed, bOption);
+	const size_t tensorSize = (size_t)w*h*3*(bOption ? 2 : 4);
+	Check("RGBA_to_Tensor", pT, (size_t)rgbaPitch*h, tensorSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGBA_to_Tensor(s, d, w, h, rgbaPitch, bSwapRB, tensor, bInvert); });
+
+	// Hashes aligned to 8 bytes, rgb lines for a part stripe
+	verifyparams pH = p;
+	pH.dstoffset &= ~7u;
+	const unsigned int hashBytes = bOption ? w*3 : w*4;
+	Check("HashLines", pH, (size_t)rgbaPitch*h, (size_t)h*8,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::HashLines(s, hashBytes, h, rgbaPitch, reinterpret_cast<uint64_t*>(d)); });
+
+	//
+	// YUV to RGBA
+	//
+	Check("YUV422_to_RGBA", p, (size_t)uyvyPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::YUV422_to_RGBA(s, d, w, h, uyvyPitch, bInvert, bSwapRB, rgbaDest, matrix, range); });
+
+	Check("YUV422_to_Tensor", pT, (size_t)uyvyPitch*h, tensorSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::YUV422_to_Tensor(s, d, w, h, uyvyPitch, tensor, bInvert, matrix, range); });
+
+	// Scaled to about a third, or by exactly 2 or 4 with a box filter
+	// if the size allows an even destination width
+	unsigned int sw = (w + 2)/3;
+	unsigned int sh = (h + 2)/3;
+	if (bOption && (w % 8) == 0 && (h % 4) == 0) {
+		sw = w/4;
+		sh = h/4;
+	}
+	else if (bOption && (w % 4) == 0 && (h % 2) == 0) {
+		sw = w/2;
+		sh = h/2;
+	}
+	const unsigned int scaledDest = sw*4 + p.dstpad;
+	Check("YUV422_to_RGBA_scaled", p, (size_t)uyvyPitch*h, (size_t)scaledDest*sh,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::YUV422_to_RGBA_scaled(s, d, w, h, uyvyPitch, sw, sh, bInvert, bSwapRB, scaledDest, matrix, range); });
+
+	Check("ScaleImage", p, (size_t)rgbaPitch*h, (size_t)scaledDest*sh,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::ScaleImage(s, d, w, h, rgbaPitch, sw, sh, bInvert, bSwapRB, scaledDest); });
+
+	// Lookup table and alpha of each scaled line
+	const ofxNDIalphamode alpha = (p.seed & 1) ? alpha_premultiply : alpha_unpremultiply;
+	Check("ScaleImage_lut", p, (size_t)rgbaPitch*h, (size_t)scaledDest*sh,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::ScaleImage(s, d, w, h, rgbaPitch, sw, sh, bInvert, bSwapRB, scaledDest, &lut, alpha); });
+
+	// 4:2:0 chroma lines are (width+1)/2 samples
+	const unsigned int yPitch = ((w+1) & ~1u) + (p.pad & ~1u);
+	const unsigned int chromaLines = (h+1)/2;
+	Check("NV12_to_RGBA", p, (size_t)yPitch*(h + chromaLines), rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::NV12_to_RGBA(s, d, w, h, yPitch, bInvert, rgbaDest, matrix, range); });
+
+	Check("I420_to_RGBA", p, (size_t)yPitch*(h + chromaLines), rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::I420_to_RGBA(s, d, w, h, yPitch, bOption, bInvert, rgbaDest, matrix, range); });
+
+	Check("UYVA_to_RGBA", p, (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, bInvert, rgbaDest, matrix, range); });
+
+	Check("UYVA_to_RGBA_alpha", p, (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, bInvert, rgbaDest, matrix, range, alpha); });
+
+	// 16 bit planes must be aligned to 2 bytes
+	verifyparams p16 = p;
+	p16.srcoffset &= ~1u;
+	p16.dstoffset &= ~1u;
+	const unsigned int p216Pitch = ((w+1)/2)*4 + (p.pad & ~1u);
+	const unsigned int rgba16Dest = w*8 + (p.dstpad & ~1u);
+	const size_t p216Size = (size_t)p216Pitch*h*(bOption ? 3 : 2);
+	Check("P216_to_RGBA16", p16, p216Size, (size_t)rgba16Dest*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::P216_to_RGBA16(s, (unsigned short*)d, w, h, p216Pitch, bOption, bInvert, rgba16Dest, matrix, range); });
+
+	Check("P216_to_RGBA", p16, p216Size, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::P216_to_RGBA(s, d, w, h, p216Pitch, bOption, bSwapRB, bInvert, rgbaDest, matrix, range); });
+
+	Check("P216_to_RGBA_alpha", p16, p216Size, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::P216_to_RGBA(s, d, w, h, p216Pitch, bOption, bSwapRB, bInvert, rgbaDest, matrix, range, alpha); });
+
+	//
+	// Region of each frame format
+	//
+	const uint32_t fcRGBA = FourCC('R', 'G', 'B', 'A');
+	const uint32_t fcBGRA = FourCC('B', 'G', 'R', 'X');
+	CheckRegion("ConvertRegion_RGBA", p, bSwapRB ? fcBGRA : fcRGBA, (size_t)rgbaPitch*h, rgbaPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, false); });
+	CheckRegion("ConvertRegion_UYVY", p, FourCC('U', 'Y', 'V', 'Y'), (size_t)uyvyPitch*h, uyvyPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::YUV422_to_RGBA(s, d, w, h, uyvyPitch, false, false, 0, matrix, range); });
+	CheckRegion("ConvertRegion_UYVA", p, FourCC('U', 'Y', 'V', 'A'), (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, uyvyPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, false, 0, matrix, range); });
+	CheckRegion("ConvertRegion_NV12", p, FourCC('N', 'V', '1', '2'), (size_t)yPitch*(h + chromaLines), yPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::NV12_to_RGBA(s, d, w, h, yPitch, false, 0, matrix, range); });
+	CheckRegion("ConvertRegion_I420", p, bOption ? FourCC('Y', 'V', '1', '2') : FourCC('I', '4', '2', '0'),
+		(size_t)yPitch*(h + chromaLines), yPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::I420_to_RGBA(s, d, w, h, yPitch, bOption, false, 0, matrix, range); });
+	CheckRegion("ConvertRegion_P216", p16, bOption ? FourCC('P', 'A', '1', '6') : FourCC('P', '2', '1', '6'), p216Size, p216Pitch, bSwapRB,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::P216_to_RGBA(s, d, w, h, p216Pitch, bOption, bSwapRB, false, 0, matrix, range); });
+
+	// Lookup table in the conversion of each line
+	CheckRegion("ConvertRegion_RGBA_lut", p, bSwapRB ? fcBGRA : fcRGBA, (size_t)rgbaPitch*h, rgbaPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, false); }, &lut);
+	CheckRegion("ConvertRegion_UYVA_lut", p, FourCC('U', 'Y', 'V', 'A'), (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, uyvyPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, false, 0, matrix, range); }, &lut);
+	CheckRegion("ConvertRegion_NV12_lut", p, FourCC('N', 'V', '1', '2'), (size_t)yPitch*(h + chromaLines), yPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::NV12_to_RGBA(s, d, w, h, yPitch, false, 0, matrix, range); }, &lut);
+	CheckRegion("ConvertRegion_P216_lut", p16, bOption ? FourCC('P', 'A', '1', '6') : FourCC('P', '2', '1', '6'), p216Size, p216Pitch, bSwapRB,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::P216_to_RGBA(s, d, w, h, p216Pitch, bOption, bSwapRB, false, 0, matrix, range); }, &lut);
+
+	// Alpha in the conversion of each line
+	const uint32_t fcAlpha = bSwapRB ? FourCC('B', 'G', 'R', 'A') : fcRGBA;
+	CheckRegion("ConvertRegion_RGBA_alpha", p, fcAlpha, (size_t)rgbaPitch*h, rgbaPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, false); }, nullptr, alpha);
+	CheckRegion("ConvertRegion_UYVA_alpha", p, FourCC('U', 'Y', 'V', 'A'), (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, uyvyPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, false, 0, matrix, range); }, nullptr, alpha);
+	CheckRegion("ConvertRegion_RGBA_lut_unpremultiply", p, fcAlpha, (size_t)rgbaPitch*h, rgbaPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, false); }, &lut, alpha_unpremultiply);
+	CheckRegion("ConvertRegion_RGBA_lut_premultiply", p, fcAlpha, (size_t)rgbaPitch*h, rgbaPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::CopyImage(s, d, w, h, rgbaPitch, bSwapRB, false); }, &lut, alpha_premultiply);
+	CheckRegion("ConvertRegion_UYVA_lut_alpha", p, FourCC('U', 'Y', 'V', 'A'), (size_t)uyvyPitch*h + (size_t)(uyvyPitch/2)*h, uyvyPitch, false,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::UYVA_to_RGBA(s, d, w, h, uyvyPitch, false, 0, matrix, range); }, &lut, alpha);
+	CheckRegion("ConvertRegion_PA16_alpha", p16, FourCC('P', 'A', '1', '6'), (size_t)p216Pitch*h*3, p216Pitch, bSwapRB,
+		[&](const unsigned char* s, unsigned char* d) { ofxNDIutils::P216_to_RGBA(s, d, w, h, p216Pitch, true, bSwapRB, false, 0, matrix, range); }, nullptr, alpha);
+
+	//
+	// RGBA to YUV
+	//
+	Check("RGBA_to_YUV422", p, (size_t)rgbaPitch*h, (size_t)uyvyDest*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGBA_to_YUV422(s, d, w, h, rgbaPitch, bSwapRB, bInvert, uyvyDest, matrix); });
+
+	Check("RGBA_to_UYVA", p, (size_t)rgbaPitch*h, (size_t)uyvyDest*h + (size_t)(uyvyDest/2)*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGBA_to_UYVA(s, d, w, h, rgbaPitch, bSwapRB, bInvert, uyvyDest, matrix); });
+
+	// RGB or BGR to UYVY, or UYVA if bOption
+	const size_t rgbyuvSize = (size_t)uyvyDest*h + (bOption ? (size_t)(uyvyDest/2)*h : 0);
+	Check("RGB_to_YUV422", p, (size_t)rgbPitch*h, rgbyuvSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGB_to_YUV422(s, d, w, h, rgbPitch, bSwapRB, bInvert, uyvyDest, matrix, bOption); });
+
+	// The same as rgb2rgba followed by RGBA_to_YUV422 or RGBA_to_UYVA
+	if (Selected(kernelfilter, "RGB_to_YUV422")) {
+		std::vector<unsigned char> rgb((size_t)rgbPitch*h);
+		std::mt19937 rng(p.seed);
+		for (unsigned char &b : rgb)
+			b = (unsigned char)rng();
+		std::vector<unsigned char> rgba((size_t)w*h*4);
+		std::vector<unsigned char> yuv1(rgbyuvSize), yuv2(rgbyuvSize);
+		ofxNDIutils::rgb2rgba(rgb.data(), rgba.data(), w, h, bInvert, rgbPitch, 0, bSwapRB);
+		if (bOption)
+			ofxNDIutils::RGBA_to_UYVA(rgba.data(), yuv1.data(), w, h, 0, false, false, uyvyDest, matrix);
+		else
+			ofxNDIutils::RGBA_to_YUV422(rgba.data(), yuv1.data(), w, h, 0, false, false, uyvyDest, matrix);
+		ofxNDIutils::RGB_to_YUV422(rgb.data(), yuv2.data(), w, h, rgbPitch, bSwapRB, bInvert, uyvyDest, matrix, bOption);
+		const bool bSame = (memcmp(yuv1.data(), yuv2.data(), rgbyuvSize) == 0);
+		if (!bSame)
+			PrintFailure("RGB_to_YUV422_rgba", LevelName(ofxNDIutils::GetSIMDlevel()), p,
+				"differs from rgb2rgba and RGBA_to_YUV422", 0);
+		CountResult("RGB_to_YUV422_rgba", bSame);
+	}
+
+	// Alpha of each source line before conversion
+	Check("RGBA_to_YUV422_alpha", p, (size_t)rgbaPitch*h, (size_t)uyvyDest*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGBA_to_YUV422(s, d, w, h, rgbaPitch, bSwapRB, bInvert, uyvyDest, matrix, alpha); });
+
+	Check("RGBA_to_UYVA_alpha", p, (size_t)rgbaPitch*h, (size_t)uyvyDest*h + (size_t)(uyvyDest/2)*h,
+		[&](const unsigned char* s, unsigned char* d) {
+			ofxNDIutils::RGBA_to_UYVA(s, d, w, h, rgbaPitch, bSwapRB, bInvert, uyvyDest, matrix, alpha); });
+
+	//
+	// Functions for a specific instruction set
+	//
+	const size_t nBytes = (size_t)w*h;
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+	Check("memcpy_sse2", p, nBytes, nBytes,
+		[&](const unsigned char* s, unsigned char* d) {
+			if (ofxNDIutils::GetSIMDlevel() == simd_none) memcpy(d, s, nBytes);
+			else ofxNDIutils::memcpy_sse2(d, s, nBytes); });
+	Check("rgba_bgra_sse2", p, (size_t)rgbaPitch*h, rgbaDestSize,
+		[&](const unsigned char* s, unsigned char* d) {
+			if (ofxNDIutils::GetSIMDlevel() == simd_none) ofxNDIutils::rgba_bgra(s, d, w, h, bInvert, rgbaPitch, rgbaDest);
+			else ofxNDIutils::rgba_bgra_sse2(s, d, w, h, bInvert, rgbaPitch, rgbaDest); });
+#endif
+#if defined(OFXNDI_X86)
+	Check("memcpy_movsd", p, nBytes & ~3u, nBytes & ~3u,
+		[&](const unsigned char* s, unsigned char* d) {
+			if (ofxNDIutils::GetSIMDlevel() == simd_none) memcpy(d, s, nBytes & ~3u);
+			else ofxNDIutils::memcpy_movsd(d, s, nBytes & ~3u); });
+	if (ofxNDIutils::GetSIMDsupport() >= simd_avx2) {
+		Check("memcpy_avx2", p, nBytes, nBytes,
+			[&](const unsigned char* s, unsigned char* d) {
+				if (ofxNDIutils::GetSIMDlevel() == simd_none) memcpy(d, s, nBytes);
+				else ofxNDIutils::memcpy_avx2(d, s, nBytes); });
+		Check("rgba_bgra_avx2", p, (size_t)rgbaPitch*h, rgbaDestSize,
+			[&](const unsigned char* s, unsigned char* d) {
+				if (ofxNDIutils::GetSIMDlevel() == simd_none) ofxNDIutils::rgba_bgra(s, d, w, h, bInvert, rgbaPitch, rgbaDest);
+				else ofxNDIutils::rgba_bgra_avx2(s, d, w, h, bInvert, rgbaPitch, rgbaDest); });
+	}
+#endif
+}
+
+// Change the number of threads between frames. Each frame must be
+// complete when the function returns and match the single threaded result.
+static void VerifyThreadChange(unsigned int count, uint32_t seed)
+{
+	if (!Selected(kernelfilter, "ThreadCount"))
+		return;
+
+	const unsigned int w = 320;
+	const unsigned int h = 240;
+	std::vector<unsigned char> src((size_t)w*h*4);
+	std::mt19937 rng(seed);
+	for (unsigned char &b : src)
+		b = (unsigned char)rng();
+
+	const unsigned int nThreads = ofxNDIutils::GetThreadCount();
+	std::vector<unsigned char> ref((size_t)w*h*4);
+	ofxNDIutils::SetThreadCount(1);
+	ofxNDIutils::CopyImage((const void*)src.data(), (void*)ref.data(), w, h, w*4, w*4, true, true);
+
+	std::vector<unsigned char> dst((size_t)w*h*4);
+	for (unsigned int i = 0; i < count; i++) {
+		ofxNDIutils::SetThreadCount(1 + (i % 4));
+		for (unsigned int j = 0; j < 2; j++) {
+			memset(dst.data(), 0, dst.size());
+			ofxNDIutils::CopyImage((const void*)src.data(), (void*)dst.data(), w, h, w*4, w*4, true, true);
+			const bool bPassed = (dst == ref);
+			CountResult("ThreadCount", bPassed);
+			if (!bPassed) {
+				printf("ThreadCount - frame %u with %u threads does not match\n", i, 1 + (i % 4));
+				break;
+			}
+		}
+	}
+	ofxNDIutils::SetThreadCount(nThreads);
+}
+
+// Returns the number of failures
+static unsigned int Verify(unsigned int count, uint32_t seed)
+{
+	printf("Verify %u random tests, seed %u\n", count, seed);
+
+	CountResult("StaticInit", bStaticConversion);
+
+	const ofxNDIsimd startlevel = ofxNDIutils::GetSIMDlevel();
+	std::mt19937 rng(seed);
+	for (unsigned int i = 0; i < count; i++)
+		VerifyParams(RandomParams(rng));
+	ofxNDIutils::SetSIMDlevel(startlevel);
+	VerifyThreadChange(count, seed);
+
+	unsigned int nFailures = 0;
+	for (const verifycount &v : verifycounts) {
+		printf("%-22s %6u tests  %s\n", v.kernel.c_str(), v.tests,
+			v.failures ? (std::to_string(v.failures) + " FAILED").c_str() : "passed");
+		nFailures += v.failures;
+	}
+	printf("%s\n", nFailures ? "FAILED" : "All tests passed");
+	return nFailures;
+}
+
+int main(int argc, char* argv[])
+{
+	bool bJson = false;
+	const char* jsonfile = nullptr;
+	bool bVerify = false;
+	unsigned int verifytests = 1000;
+	uint32_t seed = 1;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--json") {
+			bJson = true;
+			if (i+1 < argc && argv[i+1][0] != '-')
+				jsonfile = argv[++i];
+		}
+		else if (arg == "--size" && i+1 < argc) {
+			sizefilter.push_back(argv[++i]);
+		}
+		else if (arg == "--kernel" && i+1 < argc) {
+			kernelfilter.push_back(argv[++i]);
+		}
+		else if (arg == "--threads" && i+1 < argc) {
+			ofxNDIutils::SetThreadCount((unsigned int)atoi(argv[++i]));
+		}
+		else if (arg == "--time" && i+1 < argc) {
+			mintime = atof(argv[++i]);
+		}
+		else if (arg == "--verify") {
+			bVerify = true;
+			if (i+1 < argc && argv[i+1][0] != '-')
+				verifytests = (unsigned int)atoi(argv[++i]);
+		}
+		else if (arg == "--seed" && i+1 < argc) {
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			printf("Usage : ofxNDIbenchmark [--json [file]] [--size name] [--kernel name] [--threads n] [--time msec]\n");
+			printf("        ofxNDIbenchmark --verify [count] [--seed n] [--kernel name] [--threads n]\n");
+			return 1;
+		}
+	}
+
+	if (bVerify) {
+		// Divide even small images between threads
+		ofxNDIutils::SetThreadMinimum(1);
+		return Verify(verifytests, seed) ? 1 : 0;
+	}
+
+	if (bJson && !jsonfile)
+		console = stderr;
+
+	fprintf(console, "ofxNDI %s - SIMD support %s - %u threads\n",
+		ofxNDIutils::GetVersion().c_str(), LevelName(ofxNDIutils::GetSIMDsupport()),
+		ofxNDIutils::GetThreadCount());
+
+	std::vector<benchresult> results;
+	const ofxNDIsimd startlevel = ofxNDIutils::GetSIMDlevel();
+	for (const benchsize &sz : sizes) {
+		if (!Selected(sizefilter, sz.name))
+			continue;
+		for (ofxNDIsimd level : levels) {
+			// Skip levels not supported by the CPU
+			if (ofxNDIutils::SetSIMDlevel(level) != level)
+				continue;
+			RunPixels(results, sz, level);
+		}
+	}
+	ofxNDIutils::SetSIMDlevel(startlevel);
+
+	RunAudio(results);
+
+	if (bJson) {
+		FILE* file = stdout;
+		if (jsonfile) {
+			file = fopen(jsonfile, "w");
+			if (!file) {
+				printf("Could not open %s\n", jsonfile);
+				return 1;
+			}
+		}
+		WriteJson(file, results);
+		if (file != stdout)
+			fclose(file);
+	}
+
+	return 0;
+}
@@ -89,9 +89,6 @@ void ofApp::setup(){
 	vidGrabber.setup(640, 480);
 	cout << "Initialized webcam [" << camdevices[camindex].deviceName << "] " << vidGrabber.getWidth() << " x " << vidGrabber.getHeight() << ")" << endl;
 
-	// Create rgba sending buffer for rgb grabber
-	campixels = new unsigned char[(unsigned int)vidGrabber.getWidth()*(unsigned int)vidGrabber.getHeight()*4];
-
 	// Set Openframeworks to send frames at the desired frame grabber rate
 	ofSetFrameRate(30);
 
@@ -123,16 +120,11 @@ void ofApp::draw() {
 	vidGrabber.draw(0, 0, ofGetWidth(), ofGetHeight());
 	if (vidGrabber.isFrameNew()) {
 
-		// NDI accepts only RGBA pixels
-		// Copy to a sending buffer if the grabber is RGB
-		if ((vidGrabber.getPixelFormat() == OF_PIXELS_RGB || vidGrabber.getPixelFormat() == OF_PIXELS_BGR) && campixels) {
-			// RGB grabber -> RGBA pixel buffer (approx 0.6 msec at 640x480)
-			ofxNDIutils::rgb2rgba((void *)vidGrabber.getPixels().getData(),	(void *)campixels,
-			(unsigned int)vidGrabber.getWidth(), (unsigned int)vidGrabber.getHeight(), false);
-			camsender.SendImage(campixels, (unsigned int)vidGrabber.getWidth(), (unsigned int)vidGrabber.getHeight());
-		}
-		else if (vidGrabber.getPixelFormat() == OF_PIXELS_RGBA || vidGrabber.getPixelFormat() == OF_PIXELS_BGRA) {
-			camsender.SendImage(vidGrabber.getPixels(), (unsigned int)vidGrabber.getWidth(), (unsigned int)vidGrabber.getHeight());
+		// RGB or BGR grabber pixels are expanded to RGBA
+		// directly in the sending buffer (SendRGBimage)
+		if (vidGrabber.getPixelFormat() == OF_PIXELS_RGB || vidGrabber.getPixelFormat() == OF_PIXELS_BGR
+		 || vidGrabber.getPixelFormat() == OF_PIXELS_RGBA || vidGrabber.getPixelFormat() == OF_PIXELS_BGRA) {
+			camsender.SendImage(vidGrabber.getPixels());
 		}
 	}
 	
@@ -182,10 +174,6 @@ void ofApp::keyPressed(int key) {
 		if (vidGrabber.setup(640, 480)) {
 			ofSetWindowShape(vidGrabber.getWidth(), vidGrabber.getHeight());
 
-			// Update the rgba sending buffer for rgb grabber
-			if (campixels) delete[] campixels;
-			campixels = new unsigned char[(unsigned int)vidGrabber.getWidth()*(unsigned int)vidGrabber.getHeight()*4];
-			
 			// The webcam resolution might have changed. Update the sender.
 			camsender.UpdateSender((unsigned int)vidGrabber.getWidth(), (unsigned int)vidGrabber.getHeight());
 			cout << "Initialized webcam [" << camdevices[camindex].deviceName << "] (" << vidGrabber.getWidth() << " x " << vidGrabber.getHeight() << ")" << endl;
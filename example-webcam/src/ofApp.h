@@ -44,6 +44,5 @@ class ofApp : public ofBaseApp {
 		std::string camsendername; // Sender name
 		int camindex = 0; // Selected webcam in the device list
 		bool bSendCam = true; // Clear to send the webcam texture
-		unsigned char* campixels = nullptr; // rgba pixel buffer
 
 };
@@ -173,6 +173,32 @@
 			   can be called independently of ReceiveImage
 	22.05.26 - Add ReceiveImage overload for no arguments
 			   Revise CreateReceiver
+	17.10.26 - ReceiveImage - convert NV12, I420 and YV12 to RGBA
+			   Return false for formats that are not converted
+			 - ReceiveImage - convert P216 and PA16 to RGBA
+			   Add SetDither, GetDither for 16 bit to 8 bit conversion
+			 - ReceiveImage - convert UYVA to RGBA including alpha
+			 - Add SetThreads, GetThreads for multi-threaded conversion
+			 - ReceiveImage - UYVY convert and flip in one pass
+			   BGRA swap and flip in one pass allowing for line stride
+			 - Add SetColorMatrix, GetColorMatrix, SetColorRange, GetColorRange
+			   for YUV conversion by each receiver
+			 - ReceiveImage - RGBA copy to the unpadded buffer allowing for line stride
+			 - Add ReceiveScaledImage - convert and scale in one pass
+			   to a receiving buffer of a different size
+			   Conversion switch moved to ConvertVideoFrame
+			 - Add ReceiveImage for a rectangle of the sender frame
+			   Only the rectangle is converted (ofxNDIutils::ConvertRegion)
+			 - Add SetAlphaMode, GetAlphaMode - premultiply or unpremultiply
+			   in the RGBA and BGRA copy pass
+			 - Add LoadLUT, SetLUT, ClearLUT, GetLUT - colour lookup table
+			   applied in the conversion pass (ofxNDIutils::ConvertRegion)
+			 - Add ReceiveTensor, SetTensorFormat, GetTensorFormat
+			   planar float32 or float16 with mean and std normalization
+			 - Premultiply or unpremultiply UYVA and PA16 in the conversion pass
+			   and scaled frames in the scaling pass. Remove AlphaVideoFrame.
+			 - ReceiveImage - copy metadata attached to a video frame
+			   for IsMetadata and GetMetadataString
 
 
 */
@@ -235,6 +261,18 @@ ofxNDIreceive::ofxNDIreceive()
 
 	// Can receive UYVY or BGRA data by default
 	m_Format = NDIlib_recv_color_format_UYVY_BGRA;
+	m_bDither = false;
+	m_ColorMatrix = matrix_auto; // BT.601, BT.709 or BT.2020 depending on width
+	m_ColorRange = range_limited;
+	m_AlphaMode = alpha_none;
+	m_ScaledWidth = 0;
+	m_ScaledHeight = 0;
+	m_RoiX = 0;
+	m_RoiY = 0;
+	m_RoiWidth = 0;
+	m_RoiHeight = 0;
+	m_TensorWidth = 0;
+	m_TensorHeight = 0;
 
 	m_senderIndex = 0;
 	m_senderName = "";
@@ -657,6 +695,105 @@ void ofxNDIreceive::SetFormat(NDIlib_recv_color_format_e format)
 	m_Format = format;
 }
 
+// Set ordered dither for 16 bit P216 and PA16 to 8 bit RGBA
+void ofxNDIreceive::SetDither(bool bDither)
+{
+	m_bDither = bDither;
+}
+
+// Get whether dither is set
+bool ofxNDIreceive::GetDither()
+{
+	return m_bDither;
+}
+
+// Set YUV color matrix for conversion to RGBA
+void ofxNDIreceive::SetColorMatrix(ofxNDIcolormatrix matrix)
+{
+	m_ColorMatrix = matrix;
+}
+
+// Get YUV color matrix for conversion to RGBA
+ofxNDIcolormatrix ofxNDIreceive::GetColorMatrix()
+{
+	return m_ColorMatrix;
+}
+
+// Set YUV range for conversion to RGBA
+void ofxNDIreceive::SetColorRange(ofxNDIcolorrange range)
+{
+	m_ColorRange = range;
+}
+
+// Get YUV range for conversion to RGBA
+ofxNDIcolorrange ofxNDIreceive::GetColorRange()
+{
+	return m_ColorRange;
+}
+
+// Set alpha conversion of received RGBA pixels
+void ofxNDIreceive::SetAlphaMode(ofxNDIalphamode mode)
+{
+	m_AlphaMode = mode;
+}
+
+// Get alpha conversion of received RGBA pixels
+ofxNDIalphamode ofxNDIreceive::GetAlphaMode()
+{
+	return m_AlphaMode;
+}
+
+// Load a .cube colour lookup table for received pixels
+// The current table is retained if the file could not be loaded
+bool ofxNDIreceive::LoadLUT(std::string path)
+{
+	return ofxNDIutils::LoadCubeLUT(path, m_LUT);
+}
+
+// Set a colour lookup table for received pixels
+void ofxNDIreceive::SetLUT(const ofxNDIlut &lut)
+{
+	m_LUT = lut;
+}
+
+// Remove the colour lookup table
+void ofxNDIreceive::ClearLUT()
+{
+	m_LUT = ofxNDIlut();
+}
+
+// Get the colour lookup table, null if none
+const ofxNDIlut *ofxNDIreceive::GetLUT()
+{
+	if (!m_LUT.b1D && m_LUT.size == 0)
+		return nullptr;
+	return &m_LUT;
+}
+
+// Set the tensor format for ReceiveTensor
+void ofxNDIreceive::SetTensorFormat(const ofxNDItensor &tensor)
+{
+	m_Tensor = tensor;
+}
+
+// Get the tensor format for ReceiveTensor
+ofxNDItensor ofxNDIreceive::GetTensorFormat()
+{
+	return m_Tensor;
+}
+
+// Set the number of threads for pixel conversion
+void ofxNDIreceive::SetThreads(unsigned int nThreads)
+{
+	ofxNDIutils::SetThreadCount(nThreads);
+}
+
+// Get the number of threads for pixel conversion
+unsigned int ofxNDIreceive::GetThreads()
+{
+	return ofxNDIutils::GetThreadCount();
+}
+
 
 // Return the received frame type
 NDIlib_frame_type_e ofxNDIreceive::GetFrameType()
@@ -1102,6 +1239,13 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 					// The caller can check whether a frame has been received
 					bReceiverConnected = true;
 
+					// Metadata attached to the video frame by the sender
+					if (video_frame.p_metadata) {
+						m_bMetadata = true;
+						m_metadataString = video_frame.p_metadata;
+					}
+
+					bool bSizeChanged = false;
 					if (m_Width != (unsigned int)video_frame.xres || m_Height != (unsigned int)video_frame.yres) {
 						m_Width = (unsigned int)video_frame.xres; // current width
 						m_Height = (unsigned int)video_frame.yres; // current height
@@ -1110,44 +1254,32 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 						height = m_Height;
 						// Return received OK for the app to handle changed dimensions
 						bRet = true;
+						bSizeChanged = true;
 					}
 
 					// Otherwise sizes are current - copy the received frame data to the local buffer
-					else if (video_frame.p_data && (uint8_t*)pixels) {
+					// The scaled, rectangle and tensor receiving buffers do not change with the sender size
+					if ((!bSizeChanged || m_ScaledWidth > 0 || m_RoiWidth > 0 || m_TensorWidth > 0) && video_frame.p_data && (uint8_t*)pixels) {
 						
-						// Video frame type
-						switch (video_frame.FourCC) {
-							// Note : If the receiver is set up to prefer BGRA or RGBA format,
-							// the slower YUV422_to_RGBA conversion function here is not used.
-							case NDIlib_FourCC_type_UYVY: // YCbCr color space
-							// Alpha component of NDIlib_FourCC_type_UYVA not supported
-							case NDIlib_FourCC_type_UYVA: // With alpha (not used)
-								// CPU conversion
-								// 5.5 msec at 1920x1080
-								ofxNDIutils::YUV422_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes);
-								break;
-							case NDIlib_FourCC_type_RGBA: // RGBA
-							case NDIlib_FourCC_type_RGBX: // RGBX
-								// Do not swap red/green
-								ofxNDIutils::CopyImage((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, false, bInvert);
-								break;
-							case NDIlib_FourCC_type_BGRA: // BGRA
-							case NDIlib_FourCC_type_BGRX: // BGRX
-								// Swap red/green : BGRA > RGBA
-								ofxNDIutils::CopyImage((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, true, bInvert);
-								break;
-							
-							// Unsupported formats
-							case NDIlib_FourCC_video_type_P216:
-							case NDIlib_FourCC_video_type_PA16:
-							case NDIlib_FourCC_type_NV12:
-							case NDIlib_FourCC_type_I420:
-							case NDIlib_FourCC_type_YV12:
-							case NDIlib_frame_type_max:
-							default:
-								break;
-
-						} // end switch received format
+						// False for a format that is not converted
+						bool bConverted = false;
+						if (m_TensorWidth > 0 && m_TensorHeight > 0)
+							bConverted = TensorVideoFrame(pixels, bInvert); // ReceiveTensor
+						else if (m_ScaledWidth > 0 && m_ScaledHeight > 0)
+							bConverted = ScaleVideoFrame(pixels, m_ScaledWidth, m_ScaledHeight, bInvert); // ReceiveScaledImage
+						else if (m_RoiWidth > 0 && m_RoiHeight > 0)
+							bConverted = CropVideoFrame(pixels, bInvert); // ReceiveImage rectangle
+						else if (GetLUT()) {
+							// Lookup table and alpha for each line in the conversion pass
+							bConverted = ofxNDIutils::ConvertRegion((const unsigned char *)video_frame.p_data, (uint32_t)video_frame.FourCC,
+								m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes,
+								pixels, 0, 0, m_Width, m_Height, bInvert, m_Width*4,
+								m_ColorMatrix, m_ColorRange, m_bDither, &m_LUT, m_AlphaMode);
+						}
+						else {
+							// Alpha in the conversion pass
+							bConverted = ConvertVideoFrame(pixels, bInvert);
+						}
 
 						// Get the current video frame timecode
 						// UTC time since the Unix Epoch (1/1/1970 00:00) with 100 ns precision.
@@ -1167,7 +1299,7 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 						UpdateFps();
 
 						// return true for successful video frame received
-						bRet = true;
+						bRet = bConverted;
 
 					} // endif video frame copy
 				} // end video frame type
@@ -1189,6 +1321,264 @@ bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
 
 }
 
+// Receive RGBA image pixels scaled to a buffer of a different size
+// The frame is converted and scaled in one pass so that the work
+// is in proportion to the receiving buffer rather than the sender size.
+bool ofxNDIreceive::ReceiveScaledImage(unsigned char *pixels,
+	unsigned int destWidth, unsigned int destHeight,
+	unsigned int &width, unsigned int &height, bool bInvert)
+{
+	if (!pixels || destWidth == 0 || destHeight == 0)
+		return false;
+
+	m_ScaledWidth = destWidth;
+	m_ScaledHeight = destHeight;
+	bool bRet = ReceiveImage(pixels, width, height, bInvert);
+	m_ScaledWidth = 0;
+	m_ScaledHeight = 0;
+
+	return bRet;
+}
+
+// Receive planar tensor
+bool ofxNDIreceive::ReceiveTensor(void *tensor,
+	unsigned int tensorWidth, unsigned int tensorHeight,
+	unsigned int &width, unsigned int &height, bool bInvert)
+{
+	if (!tensor || tensorWidth == 0 || tensorHeight == 0)
+		return false;
+
+	m_TensorWidth = tensorWidth;
+	m_TensorHeight = tensorHeight;
+	bool bRet = ReceiveImage((unsigned char *)tensor, width, height, bInvert);
+	m_TensorWidth = 0;
+	m_TensorHeight = 0;
+
+	return bRet;
+}
+
+// Receive a rectangle of the sender frame
+// Only the rectangle is converted so that the work is
+// in proportion to the rectangle rather than the sender size.
+bool ofxNDIreceive::ReceiveImage(unsigned char *pixels,
+	unsigned int x, unsigned int y,
+	unsigned int roiWidth, unsigned int roiHeight,
+	unsigned int &width, unsigned int &height, bool bInvert)
+{
+	if (!pixels || roiWidth == 0 || roiHeight == 0)
+		return false;
+
+	m_RoiX = x;
+	m_RoiY = y;
+	m_RoiWidth = roiWidth;
+	m_RoiHeight = roiHeight;
+	bool bRet = ReceiveImage(pixels, width, height, bInvert);
+	m_RoiWidth = 0;
+	m_RoiHeight = 0;
+
+	return bRet;
+}
+
+// Convert the received video frame to an RGBA buffer of the same size
+bool ofxNDIreceive::ConvertVideoFrame(unsigned char *pixels, bool bInvert)
+{
+	// False for a format that is not converted
+	bool bConverted = true;
+
+	// Video frame type
+	switch (video_frame.FourCC) {
+		// Note : If the receiver is set up to prefer BGRA or RGBA format,
+		// the slower YUV422_to_RGBA conversion function here is not used.
+		case NDIlib_FourCC_type_UYVY: // YCbCr color space
+			// CPU conversion and flip in one pass
+			// 1.0 msec at 1920x1080 (AVX2)
+			ofxNDIutils::YUV422_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, bInvert,
+				false, 0, m_ColorMatrix, m_ColorRange);
+			break;
+		case NDIlib_FourCC_type_UYVA: // UYVY with alpha plane
+			// 1.7 msec at 1920x1080 (AVX2)
+			ofxNDIutils::UYVA_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, bInvert,
+				0, m_ColorMatrix, m_ColorRange, m_AlphaMode);
+			break;
+		case NDIlib_FourCC_type_RGBA: // RGBA
+		case NDIlib_FourCC_type_RGBX: // RGBX
+			// Do not swap red/green
+			// Premultiply or unpremultiply in the same pass
+			ofxNDIutils::CopyImage((const void *)video_frame.p_data, (void *)pixels, m_Width, m_Height,
+				(unsigned int)video_frame.line_stride_in_bytes, m_Width*4, bInvert, false, m_AlphaMode);
+			break;
+		case NDIlib_FourCC_type_BGRA: // BGRA
+		case NDIlib_FourCC_type_BGRX: // BGRX
+			// Swap red/green : BGRA > RGBA
+			// Swap, flip and alpha in one pass allowing for the frame line stride
+			ofxNDIutils::CopyImage((const void *)video_frame.p_data, (void *)pixels, m_Width, m_Height,
+				(unsigned int)video_frame.line_stride_in_bytes, m_Width*4, bInvert, true, m_AlphaMode);
+			break;
+		
+		// Planar 4:2:0 formats
+		case NDIlib_FourCC_type_NV12:
+			ofxNDIutils::NV12_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, bInvert,
+				0, m_ColorMatrix, m_ColorRange);
+			break;
+		case NDIlib_FourCC_type_I420:
+			ofxNDIutils::I420_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, false, bInvert,
+				0, m_ColorMatrix, m_ColorRange);
+			break;
+		case NDIlib_FourCC_type_YV12:
+			ofxNDIutils::I420_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes, true, bInvert,
+				0, m_ColorMatrix, m_ColorRange);
+			break;
+
+		// 16 bit 4:2:2 to 8 bit RGBA
+		case NDIlib_FourCC_video_type_P216:
+		case NDIlib_FourCC_video_type_PA16: // With alpha plane
+			ofxNDIutils::P216_to_RGBA((const unsigned char *)video_frame.p_data, pixels, m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes,
+				video_frame.FourCC == NDIlib_FourCC_video_type_PA16, m_bDither, bInvert, 0, m_ColorMatrix, m_ColorRange, m_AlphaMode);
+			break;
+
+		// Unsupported formats
+		case NDIlib_frame_type_max:
+		default:
+			bConverted = false;
+			break;
+
+	} // end switch received format
+
+	return bConverted;
+
+}
+
+// Convert the received video frame to an RGBA buffer
+// of size destWidth x destHeight
+// UYVY, RGBA and BGRA are converted and scaled in one pass.
+// Other formats are converted at full size and then scaled.
+// A lookup table and alpha are applied to each scaled line.
+bool ofxNDIreceive::ScaleVideoFrame(unsigned char *pixels, unsigned int destWidth, unsigned int destHeight, bool bInvert)
+{
+	const unsigned char *source = (const unsigned char *)video_frame.p_data;
+	const unsigned int stride = (unsigned int)video_frame.line_stride_in_bytes;
+
+	switch (video_frame.FourCC) {
+		case NDIlib_FourCC_type_UYVY:
+			ofxNDIutils::YUV422_to_RGBA_scaled(source, pixels, m_Width, m_Height, stride,
+				destWidth, destHeight, bInvert, false, 0, m_ColorMatrix, m_ColorRange, GetLUT());
+			break;
+		case NDIlib_FourCC_type_RGBA:
+		case NDIlib_FourCC_type_RGBX:
+			ofxNDIutils::ScaleImage(source, pixels, m_Width, m_Height, stride,
+				destWidth, destHeight, bInvert, false, 0, GetLUT(), FrameAlphaMode());
+			break;
+		case NDIlib_FourCC_type_BGRA:
+		case NDIlib_FourCC_type_BGRX:
+			ofxNDIutils::ScaleImage(source, pixels, m_Width, m_Height, stride,
+				destWidth, destHeight, bInvert, true, 0, GetLUT(), FrameAlphaMode());
+			break;
+		default:
+			// Full size RGBA for other formats
+			m_ScaledBuffer.resize((size_t)m_Width * (size_t)m_Height * 4);
+			if (!ofxNDIutils::ConvertRegion(source, (uint32_t)video_frame.FourCC, m_Width, m_Height, stride,
+				m_ScaledBuffer.data(), 0, 0, m_Width, m_Height, false, m_Width*4,
+				m_ColorMatrix, m_ColorRange, m_bDither))
+				return false;
+			ofxNDIutils::ScaleImage(m_ScaledBuffer.data(), pixels, m_Width, m_Height, m_Width*4,
+				destWidth, destHeight, bInvert, false, 0, GetLUT(), FrameAlphaMode());
+			break;
+	}
+
+	return true;
+}
+
+// Convert the received video frame to planar tensor
+// of size m_TensorWidth x m_TensorHeight
+// UYVY, RGBA and BGRA at the sender size are converted directly
+// unless a lookup table or alpha conversion is used.
+// Otherwise the frame is converted to RGBA at the tensor size first.
+bool ofxNDIreceive::TensorVideoFrame(unsigned char *tensor, bool bInvert)
+{
+	const unsigned char *source = (const unsigned char *)video_frame.p_data;
+	const unsigned int stride = (unsigned int)video_frame.line_stride_in_bytes;
+	const bool bSameSize = (m_TensorWidth == m_Width && m_TensorHeight == m_Height);
+
+	if (bSameSize && !GetLUT()) {
+		switch (video_frame.FourCC) {
+			case NDIlib_FourCC_type_UYVY:
+				ofxNDIutils::YUV422_to_Tensor(source, tensor, m_Width, m_Height, stride,
+					m_Tensor, bInvert, m_ColorMatrix, m_ColorRange);
+				return true;
+			case NDIlib_FourCC_type_RGBA:
+			case NDIlib_FourCC_type_RGBX:
+			case NDIlib_FourCC_type_BGRA:
+			case NDIlib_FourCC_type_BGRX:
+				if (m_AlphaMode == alpha_none) {
+					ofxNDIutils::RGBA_to_Tensor(source, tensor, m_Width, m_Height, stride,
+						video_frame.FourCC == NDIlib_FourCC_type_BGRA || video_frame.FourCC == NDIlib_FourCC_type_BGRX,
+						m_Tensor, bInvert);
+					return true;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	// RGBA at the tensor size
+	m_TensorBuffer.resize((size_t)m_TensorWidth * (size_t)m_TensorHeight * 4);
+	unsigned char *rgba = m_TensorBuffer.data();
+	if (bSameSize) {
+		if (!ofxNDIutils::ConvertRegion(source, (uint32_t)video_frame.FourCC, m_Width, m_Height, stride,
+			rgba, 0, 0, m_Width, m_Height, bInvert, m_Width*4,
+			m_ColorMatrix, m_ColorRange, m_bDither, GetLUT(), m_AlphaMode))
+			return false;
+	}
+	else if (!ScaleVideoFrame(rgba, m_TensorWidth, m_TensorHeight, bInvert)) {
+		return false;
+	}
+
+	ofxNDIutils::RGBA_to_Tensor(rgba, tensor, m_TensorWidth, m_TensorHeight, 0, false, m_Tensor);
+	return true;
+}
+
+// Convert a rectangle of the received video frame to an RGBA buffer
+// of size m_RoiWidth x m_RoiHeight at m_RoiX, m_RoiY in the frame.
+// The rectangle is clipped to the frame.
+bool ofxNDIreceive::CropVideoFrame(unsigned char *pixels, bool bInvert)
+{
+	if (m_RoiX >= m_Width || m_RoiY >= m_Height)
+		return false;
+
+	const unsigned int width = std::min(m_RoiWidth, m_Width - m_RoiX);
+	const unsigned int height = std::min(m_RoiHeight, m_Height - m_RoiY);
+	const unsigned int pitch = m_RoiWidth*4;
+
+	// Clipped lines are at the bottom of the buffer if inverted
+	if (bInvert)
+		pixels += (size_t)(m_RoiHeight - height) * pitch;
+
+	if (!ofxNDIutils::ConvertRegion((const unsigned char *)video_frame.p_data, (uint32_t)video_frame.FourCC,
+		m_Width, m_Height, (unsigned int)video_frame.line_stride_in_bytes,
+		pixels, m_RoiX, m_RoiY, width, height, bInvert, pitch,
+		m_ColorMatrix, m_ColorRange, m_bDither, GetLUT(), m_AlphaMode))
+		return false;
+
+	return true;
+}
+
+// Alpha mode for the received format
+// alpha_none for formats without alpha
+ofxNDIalphamode ofxNDIreceive::FrameAlphaMode()
+{
+	switch (video_frame.FourCC) {
+		case NDIlib_FourCC_type_RGBA:
+		case NDIlib_FourCC_type_BGRA:
+		case NDIlib_FourCC_type_UYVA:
+		case NDIlib_FourCC_video_type_PA16:
+			return m_AlphaMode;
+		default:
+			// Opaque
+			return alpha_none;
+	}
+}
+
 // Receive image pixels without a receiving buffer
 // The received video frame is then held in ofxReceive class.
 // (Used for receiving Openframeworks ofTexture, ofFbo, ofImage and ofPixels)
@@ -1321,6 +1711,12 @@ bool ofxNDIreceive::ReceiveImage(unsigned int &width, unsigned int &height)
 					// The caller can check whether a frame has been received
 					bReceiverConnected = true;
 
+					// Metadata attached to the video frame by the sender
+					if (video_frame.p_metadata) {
+						m_bMetadata = true;
+						m_metadataString = video_frame.p_metadata;
+					}
+
 					if (m_Width != (unsigned int)video_frame.xres || m_Height != (unsigned int)video_frame.yres) {
 						m_Width  = (unsigned int)video_frame.xres;
 						m_Height = (unsigned int)video_frame.yres;
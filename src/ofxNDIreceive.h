@@ -142,6 +142,52 @@ public:
 		unsigned int &width, unsigned int &height,
 		bool bInvert = false);
 
+	// Receive image pixels scaled to a buffer of a different size
+	// Conversion and scaling are in one pass for UYVY, RGBA and BGRA.
+	// Reduction by exactly 2, 4 or 8 is box filtered, other sizes are bilinear.
+	// The receiving buffer is not re-allocated for a change of sender size.
+	// - pixels | receiving buffer destWidth*destHeight*4 bytes
+	// - destWidth | receiving buffer width
+	// - destHeight | receiving buffer height
+	// - width | received sender width
+	// - height | received sender height
+	// - bInvert | flip the image
+	bool ReceiveScaledImage(unsigned char *pixels,
+		unsigned int destWidth, unsigned int destHeight,
+		unsigned int &width, unsigned int &height,
+		bool bInvert = false);
+
+	// Receive a rectangle of the sender frame to a buffer of the rectangle size
+	// Only the rectangle is converted, for all received formats.
+	// A rectangle extending outside the frame is clipped
+	// and the remainder of the receiving buffer is unchanged.
+	// - pixels | receiving buffer roiWidth*roiHeight*4 bytes
+	// - x, y | top left of the rectangle in the sender frame
+	// - roiWidth, roiHeight | rectangle size
+	// - width | received sender width
+	// - height | received sender height
+	// - bInvert | flip the image
+	bool ReceiveImage(unsigned char *pixels,
+		unsigned int x, unsigned int y,
+		unsigned int roiWidth, unsigned int roiHeight,
+		unsigned int &width, unsigned int &height,
+		bool bInvert = false);
+
+	// Receive planar float32 or float16 (CHW) for inference (see SetTensorFormat)
+	// UYVY, RGBA and BGRA at the sender size are converted directly.
+	// Other formats and sizes are converted to RGBA at the tensor size first.
+	// The color matrix, lookup table and alpha mode apply as for ReceiveImage.
+	// - tensor | three planes of tensorWidth*tensorHeight values
+	//            32 byte alignment is recommended
+	// - tensorWidth, tensorHeight | tensor plane size
+	// - width | received sender width
+	// - height | received sender height
+	// - bInvert | flip the image
+	bool ReceiveTensor(void *tensor,
+		unsigned int tensorWidth, unsigned int tensorHeight,
+		unsigned int &width, unsigned int &height,
+		bool bInvert = false);
+
 	// Receive image pixels without a receiving buffer
 	// The received video frame is held in ofxReceive class.
 	// Use the video frame data pointer externally with GetVideoData()
@@ -236,11 +282,76 @@ public:
 	// Set receiver preferred format
 	void SetFormat(NDIlib_recv_color_format_e format);
 
+	// Set ordered dither for 16 bit P216 and PA16 to 8 bit RGBA
+	// (P216 is received with NDIlib_recv_color_format_best)
+	// Initialized false
+	void SetDither(bool bDither = true);
+
+	// Get whether dither is set
+	bool GetDither();
+
+	// Set YUV color matrix for conversion to RGBA
+	// Initialized matrix_auto
+	// BT.601 for width less than 720, BT.709 less than 3840, otherwise BT.2020
+	void SetColorMatrix(ofxNDIcolormatrix matrix = matrix_auto);
+
+	// Get YUV color matrix for conversion to RGBA
+	ofxNDIcolormatrix GetColorMatrix();
+
+	// Set YUV range for conversion to RGBA
+	// Initialized range_limited (Y 16-235)
+	void SetColorRange(ofxNDIcolorrange range = range_limited);
+
+	// Get YUV range for conversion to RGBA
+	ofxNDIcolorrange GetColorRange();
+
+	// Set alpha conversion of received RGBA pixels
+	// alpha_premultiply - straight to premultiplied
+	// alpha_unpremultiply - premultiplied to straight
+	// Initialized alpha_none
+	void SetAlphaMode(ofxNDIalphamode mode = alpha_none);
+
+	// Get alpha conversion of received RGBA pixels
+	ofxNDIalphamode GetAlphaMode();
+
+	// Load a .cube colour lookup table for received pixels
+	// 1D tables, 3D lattice or both (see ofxNDIutils::LoadCubeLUT).
+	// The table is applied to each line as it is converted
+	// and before alpha conversion.
+	bool LoadLUT(std::string path);
+
+	// Set a lookup table created by the application
+	void SetLUT(const ofxNDIlut &lut);
+
+	// Remove the lookup table
+	void ClearLUT();
+
+	// Get the lookup table, null if none
+	const ofxNDIlut *GetLUT();
+
+	// Set mean, std, float16 and plane order for ReceiveTensor
+	// Initialized float32 RGB 0-1
+	void SetTensorFormat(const ofxNDItensor &tensor);
+
+	// Get the tensor format
+	ofxNDItensor GetTensorFormat();
+
+	// Set the number of threads for pixel conversion
+	// 0 - number of processor cores, 1 - single threaded (default)
+	// Frames from 1280x720 are divided between threads
+	// (see ofxNDIutils::SetThreadCount and SetThreadMinimum).
+	// The threads are shared by all senders and receivers.
+	void SetThreads(unsigned int nThreads);
+
+	// Get the number of threads for pixel conversion
+	unsigned int GetThreads();
+
 	// Received frame type
 	NDIlib_frame_type_e GetFrameType();
 
 	// Is the current frame MetaData ?
-	// Use when ReceiveImage fails
+	// Use when ReceiveImage fails, or after a video frame
+	// for metadata attached to the frame by the sender
 	bool IsMetadata();
 
 	// Return the current MetaData string
@@ -306,6 +417,27 @@ private:
 	unsigned int m_Width;
 	unsigned int m_Height;
 	NDIlib_recv_color_format_e m_Format;
+	bool m_bDither; // Dither for 16 bit to 8 bit RGBA
+	ofxNDIcolormatrix m_ColorMatrix; // YUV to RGBA conversion matrix
+	ofxNDIcolorrange m_ColorRange; // YUV to RGBA conversion range
+	ofxNDIalphamode m_AlphaMode; // Premultiply or unpremultiply received pixels
+	ofxNDIlut m_LUT; // Colour lookup table for received pixels
+	ofxNDIalphamode FrameAlphaMode(); // alpha_none for formats without alpha
+	unsigned int m_ScaledWidth; // ReceiveScaledImage buffer size
+	unsigned int m_ScaledHeight;
+	std::vector<unsigned char> m_ScaledBuffer; // Full size RGBA for formats not scaled directly
+	bool ConvertVideoFrame(unsigned char *pixels, bool bInvert); // Received frame to RGBA
+	unsigned int m_RoiX; // ReceiveImage rectangle
+	unsigned int m_RoiY;
+	unsigned int m_RoiWidth;
+	unsigned int m_RoiHeight;
+	bool ScaleVideoFrame(unsigned char *pixels, unsigned int destWidth, unsigned int destHeight, bool bInvert); // Received frame to scaled RGBA
+	unsigned int m_TensorWidth; // ReceiveTensor plane size
+	unsigned int m_TensorHeight;
+	ofxNDItensor m_Tensor; // Tensor normalization
+	std::vector<unsigned char> m_TensorBuffer; // RGBA at the tensor size if not converted directly
+	bool TensorVideoFrame(unsigned char *tensor, bool bInvert); // Received frame to planar tensor
+	bool CropVideoFrame(unsigned char *pixels, bool bInvert); // Received frame rectangle to RGBA
 
 	std::vector<std::string> NDIsenders; // List of sender names
 	int m_nSenders;// Sender count
@@ -90,6 +90,29 @@
 	03.05.26 - All ReceiveImage functions - test for allocation together with size change
 			   to re-allocate. Remove initial return if not allocated.
 			   Receiving texture/fbo/image/buffer can be initially unallocated.
+	17.10.26 - ReceiveImage pixels and GetPixelData - NV12, I420 and YV12
+			   converted to RGBA by the CPU
+			 - ReceiveImage pixels and GetPixelData - P216 and PA16 to RGBA
+			   Add ReceiveImage ofShortPixels for 16 bit RGBA
+			   Add SetDither, GetDither
+			 - ReceiveImage pixels and GetPixelData - UYVA to RGBA with alpha
+			 - GetPixelData pixels - BGRA copy and swap in one pass
+			   UYVY, RGBA and BGRA allow for the video line stride
+			 - ReceiveImage pixels - re-allocate if not RGBA
+			 - Add SetColorMatrix, SetColorRange for YUV to RGBA conversion
+			   UYVY shader uses the selected matrix if not auto
+			 - Add ReceiveImage ofPixels scaled and ReceiveScaledImage
+			   for reduced size tiles
+			 - Add ReceiveImage ofPixels and char buffer for a rectangle
+			   of the sender frame
+			 - Add SetAlphaMode, GetAlphaMode
+			   GetPixelData ofPixels - premultiply or unpremultiply
+			 - Add LoadLUT, SetLUT, ClearLUT
+			   GetPixelData ofPixels - lookup table in the conversion pass
+			 - Add ReceiveTensor, SetTensorFormat, GetTensorFormat
+			 - GetPixelData ofPixels - UYVA and PA16 alpha in the conversion pass
+			 - GetPixelData ofTexture - lookup table and alpha on the CPU
+			   in the conversion pass for all formats
 	
 */
 #include "ofxNDIreceiver.h"
@@ -280,6 +303,83 @@ bool ofxNDIreceiver::ReceiveImage(ofPixels &buffer)
 	unsigned int width = (unsigned int)buffer.getWidth();
 	unsigned int height = (unsigned int)buffer.getHeight();
 
+	// Receive a pixel image first
+	if (NDIreceiver.ReceiveImage(width, height)) {
+
+		// Check for allocation or changed sender dimensions
+		// The pixel data is always RGBA
+		if (!buffer.isAllocated()
+			|| width != (unsigned int)buffer.getWidth()
+			|| height != (unsigned int)buffer.getHeight()
+			|| buffer.getNumChannels() != 4) {
+			buffer.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+		}
+
+		// Get the NDI frame pixel data into the pixel buffer
+		return GetPixelData(buffer);
+	}
+
+	return false;
+
+}
+
+// Receive ofPixels scaled to width x height
+bool ofxNDIreceiver::ReceiveImage(ofPixels &buffer, unsigned int width, unsigned int height)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	if (width == 0 || height == 0)
+		return false;
+
+	// The buffer size is independent of the sender size
+	if (!buffer.isAllocated()
+		|| width != (unsigned int)buffer.getWidth()
+		|| height != (unsigned int)buffer.getHeight()
+		|| buffer.getNumChannels() != 4) {
+		buffer.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+	}
+
+	unsigned int senderwidth = 0;
+	unsigned int senderheight = 0;
+	return NDIreceiver.ReceiveScaledImage(buffer.getData(), width, height, senderwidth, senderheight);
+}
+
+// Receive ofPixels for a rectangle of the sender frame
+bool ofxNDIreceiver::ReceiveImage(ofPixels &buffer, unsigned int x, unsigned int y,
+	unsigned int width, unsigned int height)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	if (width == 0 || height == 0)
+		return false;
+
+	// The buffer size is the rectangle size
+	if (!buffer.isAllocated()
+		|| width != (unsigned int)buffer.getWidth()
+		|| height != (unsigned int)buffer.getHeight()
+		|| buffer.getNumChannels() != 4) {
+		buffer.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+	}
+
+	unsigned int senderwidth = 0;
+	unsigned int senderheight = 0;
+	return NDIreceiver.ReceiveImage(buffer.getData(), x, y, width, height, senderwidth, senderheight);
+}
+
+// Receive 16 bit ofShortPixels
+bool ofxNDIreceiver::ReceiveImage(ofShortPixels &buffer)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	unsigned int width = (unsigned int)buffer.getWidth();
+	unsigned int height = (unsigned int)buffer.getHeight();
+
 	// Receive a pixel image first
 	if (NDIreceiver.ReceiveImage(width, height)) {
 
@@ -290,23 +390,78 @@ bool ofxNDIreceiver::ReceiveImage(ofPixels &buffer)
 			buffer.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
 		}
 
-		// Get the video frame buffer pointer
 		unsigned char *videoData = NDIreceiver.GetVideoData();
 		if (!videoData) {
-			// Ensure the video buffer is freed
 			NDIreceiver.FreeVideoData();
 			return false;
 		}
 
-		// Get the NDI frame pixel data into the pixel buffer
+		if (NDIreceiver.GetVideoType() == NDIlib_FourCC_type_P216
+		 || NDIreceiver.GetVideoType() == NDIlib_FourCC_type_PA16) {
+			// Full 16 bit depth
+			ofxNDIutils::P216_to_RGBA16((const unsigned char *)videoData,
+				buffer.getData(), width, height, NDIreceiver.GetVideoStride(),
+				NDIreceiver.GetVideoType() == NDIlib_FourCC_type_PA16, false, 0,
+				NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+			NDIreceiver.FreeVideoData();
+			return true;
+		}
+
+		// 8 bit formats
+		if (!ndiPixels.isAllocated()
+			|| width  != (unsigned int)ndiPixels.getWidth()
+			|| height != (unsigned int)ndiPixels.getHeight()) {
+			ndiPixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+		}
+		if (GetPixelData(ndiPixels)) {
+			// ofPixels conversion scales 8 bit values to 16 bit
+			buffer = ndiPixels;
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+// Get NDI video frame pixel data into an RGBA pixel buffer
+// The buffer must be allocated to the frame size
+bool ofxNDIreceiver::GetPixelData(ofPixels &buffer)
+{
+	unsigned int width = (unsigned int)buffer.getWidth();
+	unsigned int height = (unsigned int)buffer.getHeight();
+
+	// Get the video frame buffer pointer
+	unsigned char *videoData = NDIreceiver.GetVideoData();
+	if (!videoData) {
+		// Ensure the video buffer is freed
+		NDIreceiver.FreeVideoData();
+		return false;
+	}
+
+	// Get the NDI frame pixel data into the pixel buffer
+	const ofxNDIlut *lut = NDIreceiver.GetLUT();
+	if (lut) {
+		// Lookup table and alpha for each line in the conversion pass
+		ofxNDIutils::ConvertRegion((const unsigned char *)videoData, (uint32_t)NDIreceiver.GetVideoType(),
+			width, height, NDIreceiver.GetVideoStride(), buffer.getData(), 0, 0, width, height, false, 0,
+			NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange(), NDIreceiver.GetDither(), lut,
+			NDIreceiver.GetAlphaMode());
+	}
+	else {
 		switch (NDIreceiver.GetVideoType()) {
 
 			case NDIlib_FourCC_type_UYVA: // YCbCr using 4:2:2:4
-				printf("ReceiveImage pixels - UYVA format not supported\n"); break;
+				ofxNDIutils::UYVA_to_RGBA((const unsigned char *)videoData,
+					buffer.getData(), width, height, NDIreceiver.GetVideoStride(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange(), NDIreceiver.GetAlphaMode());
+				break;
 			case NDIlib_FourCC_type_P216: // YCbCr using 4:2:2 in 16bpp
-				printf("ReceiveImage pixels - P216 format not supported\n"); break;
 			case NDIlib_FourCC_type_PA16: // YCbCr using 4:2:2:4 in 16bpp
-				printf("ReceiveImage pixels - PA16 format not supported\n");
+				ofxNDIutils::P216_to_RGBA((const unsigned char *)videoData,
+					buffer.getData(), width, height, NDIreceiver.GetVideoStride(),
+					NDIreceiver.GetVideoType() == NDIlib_FourCC_type_PA16, NDIreceiver.GetDither(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange(), NDIreceiver.GetAlphaMode());
 				break;
 
 			// Note : the receiver prefers UYVY/BGRA format by default
@@ -315,32 +470,47 @@ bool ofxNDIreceiver::ReceiveImage(ofPixels &buffer)
 			// function here is not used.
 			case NDIlib_FourCC_type_UYVY: // YCbCr using 4:2:2
 				ofxNDIutils::YUV422_to_RGBA((const unsigned char *)videoData,
-					buffer.getData(), width, height);
+					buffer.getData(), width, height, NDIreceiver.GetVideoStride(), false, false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
 				break;
 
+			// Planar 4:2:0
+			case NDIlib_FourCC_type_NV12:
+				ofxNDIutils::NV12_to_RGBA((const unsigned char *)videoData,
+					buffer.getData(), width, height, NDIreceiver.GetVideoStride(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+				break;
+			case NDIlib_FourCC_type_I420:
+			case NDIlib_FourCC_type_YV12:
+				ofxNDIutils::I420_to_RGBA((const unsigned char *)videoData,
+					buffer.getData(), width, height, NDIreceiver.GetVideoStride(),
+					NDIreceiver.GetVideoType() == NDIlib_FourCC_type_YV12, false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+				break;
+
+			// Copy between buffers so that the videoData pointer can be freed
 			case NDIlib_FourCC_type_RGBA: // RGBA
 			case NDIlib_FourCC_type_RGBX: // RGBX
-				// setFromPixels copies between buffers so that the videoData pointer can be freed
-				buffer.setFromPixels((unsigned char *)videoData, width, height, OF_PIXELS_RGBA);
+				// Premultiply or unpremultiply in the same pass
+				ofxNDIutils::CopyImage((const void *)videoData, (void *)buffer.getData(),
+					width, height, NDIreceiver.GetVideoStride(), width*4, false, false, NDIreceiver.GetAlphaMode());
 				break;
 			case NDIlib_FourCC_type_BGRA: // BGRA
 			case NDIlib_FourCC_type_BGRX: // BGRX
-				buffer.setFromPixels((unsigned char *)videoData, width, height, OF_PIXELS_RGBA);
-				buffer.swapRgb();
+				// Copy, swap red/blue and alpha in one pass
+				ofxNDIutils::CopyImage((const void *)videoData, (void *)buffer.getData(),
+					width, height, NDIreceiver.GetVideoStride(), width*4, false, true, NDIreceiver.GetAlphaMode());
 				break;
 			default:
 				// Unsupported format
 				break;
 		} // end switch received format
-
-		// Free the NDI video buffer
-		NDIreceiver.FreeVideoData();
-
-		return true;
 	}
 
-	return false;
+	// Free the NDI video buffer
+	NDIreceiver.FreeVideoData();
 
+	return true;
 }
 
 // Receive image pixels to an unsigned char buffer
@@ -365,6 +535,55 @@ bool ofxNDIreceiver::ReceiveImage(unsigned char *pixels,
 	return NDIreceiver.ReceiveImage(pixels, width, height, bInvert);
 }
 
+// Receive image pixels scaled to a char buffer of a different size
+bool ofxNDIreceiver::ReceiveScaledImage(unsigned char *pixels,
+	unsigned int destWidth, unsigned int destHeight, bool bInvert)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	if (!pixels)
+		return false;
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	return NDIreceiver.ReceiveScaledImage(pixels, destWidth, destHeight, width, height, bInvert);
+}
+
+// Receive a rectangle of the sender frame to a char buffer
+bool ofxNDIreceiver::ReceiveImage(unsigned char *pixels,
+	unsigned int x, unsigned int y,
+	unsigned int width, unsigned int height, bool bInvert)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	if (!pixels)
+		return false;
+
+	unsigned int senderwidth = 0;
+	unsigned int senderheight = 0;
+	return NDIreceiver.ReceiveImage(pixels, x, y, width, height, senderwidth, senderheight, bInvert);
+}
+
+// Receive planar normalized tensor for inference
+bool ofxNDIreceiver::ReceiveTensor(void *tensor,
+	unsigned int width, unsigned int height, bool bInvert)
+{
+	// Check for receiver creation
+	if (!OpenReceiver())
+		return false;
+
+	if (!tensor)
+		return false;
+
+	unsigned int senderwidth = 0;
+	unsigned int senderheight = 0;
+	return NDIreceiver.ReceiveTensor(tensor, width, height, senderwidth, senderheight, bInvert);
+}
+
 // Create a finder to look for a sources on the network
 void ofxNDIreceiver::CreateFinder()
 {
@@ -515,6 +734,84 @@ void ofxNDIreceiver::SetFormat(NDIlib_recv_color_format_e format)
 	return NDIreceiver.SetFormat(format);
 }
 
+// Set ordered dither for 16 bit P216 and PA16 to 8 bit RGBA
+void ofxNDIreceiver::SetDither(bool bDither)
+{
+	NDIreceiver.SetDither(bDither);
+}
+
+// Get whether dither is set
+bool ofxNDIreceiver::GetDither()
+{
+	return NDIreceiver.GetDither();
+}
+
+// Set YUV color matrix for received frames
+void ofxNDIreceiver::SetColorMatrix(ofxNDIcolormatrix matrix)
+{
+	NDIreceiver.SetColorMatrix(matrix);
+}
+
+// Get YUV color matrix
+ofxNDIcolormatrix ofxNDIreceiver::GetColorMatrix()
+{
+	return NDIreceiver.GetColorMatrix();
+}
+
+// Set YUV color range for received frames
+void ofxNDIreceiver::SetColorRange(ofxNDIcolorrange range)
+{
+	NDIreceiver.SetColorRange(range);
+}
+
+// Get YUV color range
+ofxNDIcolorrange ofxNDIreceiver::GetColorRange()
+{
+	return NDIreceiver.GetColorRange();
+}
+
+// Set alpha conversion of received pixels
+void ofxNDIreceiver::SetAlphaMode(ofxNDIalphamode mode)
+{
+	NDIreceiver.SetAlphaMode(mode);
+}
+
+// Get alpha conversion of received pixels
+ofxNDIalphamode ofxNDIreceiver::GetAlphaMode()
+{
+	return NDIreceiver.GetAlphaMode();
+}
+
+// Load a .cube colour lookup table for received pixels
+bool ofxNDIreceiver::LoadLUT(std::string path)
+{
+	return NDIreceiver.LoadLUT(path);
+}
+
+// Set a colour lookup table for received pixels
+void ofxNDIreceiver::SetLUT(const ofxNDIlut &lut)
+{
+	NDIreceiver.SetLUT(lut);
+}
+
+// Remove the colour lookup table
+void ofxNDIreceiver::ClearLUT()
+{
+	NDIreceiver.ClearLUT();
+}
+
+// Set the tensor format for ReceiveTensor
+void ofxNDIreceiver::SetTensorFormat(const ofxNDItensor &tensor)
+{
+	NDIreceiver.SetTensorFormat(tensor);
+}
+
+// Get the tensor format for ReceiveTensor
+ofxNDItensor ofxNDIreceiver::GetTensorFormat()
+{
+	return NDIreceiver.GetTensorFormat();
+}
+
 
 //
 // Bandwidth
@@ -642,8 +939,43 @@ bool ofxNDIreceiver::GetPixelData(ofTexture &texture)
 	// printf("GetPixelData format FourCC = %d (%s)\n", NDIreceiver.GetVideoType(), fourChar); // 1094862674, 1094862674
 	// return false;
 
+	// A lookup table, or alpha conversion of a format with alpha,
+	// is applied on the CPU in the conversion pass for all formats
+	// and the RGBA result is loaded to the texture.
+	// The UYVY shader and the direct RGBA and BGRA loads are not used.
+	const NDIlib_FourCC_video_type_e type = NDIreceiver.GetVideoType();
+	const bool bAlpha = NDIreceiver.GetAlphaMode() != alpha_none
+		&& (type == NDIlib_FourCC_type_RGBA || type == NDIlib_FourCC_type_BGRA
+		 || type == NDIlib_FourCC_type_UYVA || type == NDIlib_FourCC_type_PA16);
+	if (NDIreceiver.GetLUT() || bAlpha) {
+		width  = (unsigned int)texture.getWidth();
+		height = (unsigned int)texture.getHeight();
+		if (width == 0 || height == 0) {
+			NDIreceiver.FreeVideoData();
+			return false;
+		}
+		if (!ndiPixels.isAllocated()
+			|| width  != (unsigned int)ndiPixels.getWidth()
+			|| height != (unsigned int)ndiPixels.getHeight()) {
+			ndiPixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+		}
+		const bool bConverted = ofxNDIutils::ConvertRegion((const unsigned char *)videoData, (uint32_t)type,
+			width, height, NDIreceiver.GetVideoStride(), ndiPixels.getData(), 0, 0, width, height, false, 0,
+			NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange(), NDIreceiver.GetDither(),
+			NDIreceiver.GetLUT(), NDIreceiver.GetAlphaMode());
+		if (bConverted) {
+			if (m_bUpload)
+				LoadTexturePixels(texture.getTextureData().textureID, texture.getTextureData().textureTarget, width, height, ndiPixels.getData(), GL_RGBA);
+			else
+				texture.loadData(ndiPixels.getData(), (int)width, (int)height, GL_RGBA);
+		}
+		// Free the NDI video buffer
+		NDIreceiver.FreeVideoData();
+		return bConverted;
+	}
+
 	// Get the NDI video frame pixel data into the texture
-	switch (NDIreceiver.GetVideoType()) {
+	switch (type) {
 
 		// Note : the receiver is set up to prefer UYVY/BGRA format by default
 		// and can receive UYVY or RGBA data
@@ -712,7 +1044,10 @@ bool ofxNDIreceiver::GetPixelData(ofTexture &texture)
 			}
 
 			// BT601 SD, BT709 HD or BT2020 UHD
-			if(width < 720)
+			// unless a matrix has been set for the receiver
+			if (NDIreceiver.GetColorMatrix() != matrix_auto)
+				m_colormatrix = (int)NDIreceiver.GetColorMatrix();
+			else if(width < 720)
 				m_colormatrix = 0;
 			else if(width < 3840)
 				m_colormatrix = 1;
@@ -736,13 +1071,48 @@ bool ofxNDIreceiver::GetPixelData(ofTexture &texture)
 
 			break;
 
+		// UYVY with alpha, planar 4:2:0 and 16 bit 4:2:2 formats
+		// Convert to RGBA pixels and load the RGBA receiving texture
 		case NDIlib_FourCC_type_UYVA: // YCbCr using 4:2:2:4
-			printf("GetPixelData - UYVA format not supported\n"); break;
+		case NDIlib_FourCC_type_NV12:
+		case NDIlib_FourCC_type_I420:
+		case NDIlib_FourCC_type_YV12:
 		case NDIlib_FourCC_type_P216: // YCbCr using 4:2:2 in 16bpp
-			printf("GetPixelData - P216 format not supported\n"); break;
 		case NDIlib_FourCC_type_PA16: // YCbCr using 4:2:2:4 in 16bpp
-			printf("GetPixelData - PA16 format not supported\n");
+			width  = (unsigned int)texture.getWidth();
+			height = (unsigned int)texture.getHeight();
+			if (width == 0 || height == 0)
+				break;
+			if (!ndiPixels.isAllocated()
+				|| width  != (unsigned int)ndiPixels.getWidth()
+				|| height != (unsigned int)ndiPixels.getHeight()) {
+				ndiPixels.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
+			}
+			if (NDIreceiver.GetVideoType() == NDIlib_FourCC_type_UYVA)
+				ofxNDIutils::UYVA_to_RGBA((const unsigned char *)videoData, ndiPixels.getData(),
+					width, height, NDIreceiver.GetVideoStride(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+			else if (NDIreceiver.GetVideoType() == NDIlib_FourCC_type_NV12)
+				ofxNDIutils::NV12_to_RGBA((const unsigned char *)videoData, ndiPixels.getData(),
+					width, height, NDIreceiver.GetVideoStride(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+			else if (NDIreceiver.GetVideoType() == NDIlib_FourCC_type_P216
+				|| NDIreceiver.GetVideoType() == NDIlib_FourCC_type_PA16)
+				ofxNDIutils::P216_to_RGBA((const unsigned char *)videoData, ndiPixels.getData(),
+					width, height, NDIreceiver.GetVideoStride(),
+					NDIreceiver.GetVideoType() == NDIlib_FourCC_type_PA16, NDIreceiver.GetDither(), false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+			else
+				ofxNDIutils::I420_to_RGBA((const unsigned char *)videoData, ndiPixels.getData(),
+					width, height, NDIreceiver.GetVideoStride(),
+					NDIreceiver.GetVideoType() == NDIlib_FourCC_type_YV12, false, 0,
+					NDIreceiver.GetColorMatrix(), NDIreceiver.GetColorRange());
+			if (m_bUpload)
+				LoadTexturePixels(texture.getTextureData().textureID, texture.getTextureData().textureTarget, width, height, ndiPixels.getData(), GL_RGBA);
+			else
+				texture.loadData(ndiPixels.getData(), (int)width, (int)height, GL_RGBA);
 			break;
+
 		case NDIlib_FourCC_type_RGBX: // RGBX
 		case NDIlib_FourCC_type_RGBA: // RGBA
 			// RGBA data - load pixels directly to the RGBA receiving texture
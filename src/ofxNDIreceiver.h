@@ -29,6 +29,11 @@
 			   Default format - NDIlib_recv_color_format_UYVY_BGRA
 			 - Update to NDI version 6.2.1
 	26.12.25 - Add variables for UYVY > RGBA conversion shaders
+	17.10.26 - Add ReceiveImage ofShortPixels, SetDither, GetDither
+			 - Add SetColorMatrix, GetColorMatrix, SetColorRange, GetColorRange
+			 - Add SetAlphaMode, GetAlphaMode
+			 - Add LoadLUT, SetLUT, ClearLUT
+			 - Add ReceiveTensor, SetTensorFormat, GetTensorFormat
 
 */
 
@@ -107,6 +112,23 @@ public:
 	// - buffer re-allocated for changed sender dimensions
 	bool ReceiveImage(ofPixels &pixels);
 
+	// Receive a pixel buffer scaled to width x height
+	// - buffer allocated RGBA at the given size, not the sender size
+	// - the frame is converted and scaled in one pass (see ReceiveScaledImage)
+	bool ReceiveImage(ofPixels &pixels, unsigned int width, unsigned int height);
+
+	// Receive a rectangle of the sender frame to a pixel buffer
+	// - buffer allocated RGBA at the rectangle size
+	// - x, y | top left of the rectangle in the sender frame
+	// - only the rectangle is converted
+	bool ReceiveImage(ofPixels &pixels, unsigned int x, unsigned int y,
+		unsigned int width, unsigned int height);
+
+	// Receive a 16 bit pixel buffer
+	// - buffer re-allocated for changed sender dimensions
+	// - P216 and PA16 full bit depth, other formats scaled from 8 bit
+	bool ReceiveImage(ofShortPixels &pixels);
+
 	// Receive image pixels to a char buffer
 	// - Calling application must test width and
 	//   height for change with true return
@@ -119,6 +141,34 @@ public:
 		unsigned int &width, unsigned int &height,
 		bool bInvert = false);
 
+	// Receive image pixels scaled to a char buffer of a different size
+	// - pixels | receiving buffer destWidth*destHeight*4 bytes
+	// - destWidth | receiving buffer width
+	// - destHeight | receiving buffer height
+	// - bInvert | flip the image
+	bool ReceiveScaledImage(unsigned char *pixels,
+		unsigned int destWidth, unsigned int destHeight,
+		bool bInvert = false);
+
+	// Receive a rectangle of the sender frame to a char buffer
+	// - pixels | receiving buffer width*height*4 bytes
+	// - x, y | top left of the rectangle in the sender frame
+	// - width, height | rectangle size
+	// - bInvert | flip the image
+	bool ReceiveImage(unsigned char *pixels,
+		unsigned int x, unsigned int y,
+		unsigned int width, unsigned int height,
+		bool bInvert = false);
+
+	// Receive planar normalized tensor for inference
+	// - tensor | receiving buffer width*height*3 floats
+	//   or halfs (see SetTensorFormat), 32 byte aligned recommended
+	// - width, height | tensor size, scaled if different to the sender
+	// - bInvert | flip the image
+	bool ReceiveTensor(void *tensor,
+		unsigned int width, unsigned int height,
+		bool bInvert = false);
+
 	// Create an NDI finder to find existing senders
 	void CreateFinder();
 
@@ -193,6 +243,52 @@ public:
 	// Default NDIlib_recv_color_format_UYVY_BGRA
 	void SetFormat(NDIlib_recv_color_format_e format);
 
+	// Set ordered dither for 16 bit P216 and PA16 to 8 bit RGBA
+	// Default false
+	void SetDither(bool bDither = true);
+
+	// Get whether dither is set
+	bool GetDither();
+
+	// Set YUV color matrix for conversion to RGBA
+	// Default matrix_auto (BT.601 SD, BT.709 HD or BT.2020 UHD)
+	void SetColorMatrix(ofxNDIcolormatrix matrix = matrix_auto);
+
+	// Get YUV color matrix
+	ofxNDIcolormatrix GetColorMatrix();
+
+	// Set YUV range for conversion to RGBA
+	// Default range_limited
+	void SetColorRange(ofxNDIcolorrange range = range_limited);
+
+	// Get YUV range
+	ofxNDIcolorrange GetColorRange();
+
+	// Set alpha conversion of received pixels
+	// alpha_premultiply or alpha_unpremultiply
+	// Default alpha_none
+	void SetAlphaMode(ofxNDIalphamode mode = alpha_none);
+
+	// Get alpha conversion
+	ofxNDIalphamode GetAlphaMode();
+
+	// Load a .cube colour lookup table for received pixels
+	// Applied to pixel buffers and textures in the conversion pass.
+	// Textures are then converted on the CPU instead of by shader.
+	bool LoadLUT(std::string path);
+
+	// Set a colour lookup table created by the application
+	void SetLUT(const ofxNDIlut &lut);
+
+	// Remove the colour lookup table
+	void ClearLUT();
+
+	// Set mean, std, float16 and channel order for ReceiveTensor
+	void SetTensorFormat(const ofxNDItensor &tensor);
+
+	// Get tensor format
+	ofxNDItensor GetTensorFormat();
+
 	// Set NDI low banwidth option
 	// Default false
 	void SetLowBandwidth(bool bLow = true);
@@ -242,6 +338,7 @@ public:
 private :
 
 	bool GetPixelData(ofTexture &texture);
+	bool GetPixelData(ofPixels &buffer);
 	bool LoadTexturePixels(GLuint TextureID, GLuint TextureTarget, 
 		unsigned int width, unsigned int height, 
 		const unsigned char* data, int GLformat = GL_BGRA);
@@ -255,6 +352,7 @@ private :
 	ofFbo ndiFbo;           // Utility Fbo
 	ofTexture m_yuvtexture; // shader UYVY texture
 	int m_colormatrix = 1;  // 0 - BT.601, 1 - BT.709, 2 - BT.2020
+	ofPixels ndiPixels;     // RGBA conversion buffer
 
 
 };
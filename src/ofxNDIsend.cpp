@@ -112,6 +112,49 @@
 				- pNDI_send, m_AudioData, m_audio_frame.p_data, video_frame.p_data
 				- Set m_bMetadata = false
 	16.08-26	- Add GetConnections - number of receiver connections
+	17.10.26	- SendImage - CPU conversion of RGBA or BGRA to UYVY
+				  if the output format is UYVY (no shader required)
+				- Add SendYUVimage for pixels already converted
+				- Add SetColorMatrix and GetColorMatrix
+				- SetFormat - update the video frame if the sender exists
+				- SetVideoStride - UYVY stride allows for odd width
+				- SendImage - CPU conversion of RGBA or BGRA to UYVA
+				  if the output format is UYVA
+				- Add GetVideoSize for the UYVA alpha plane
+				- Add SetThreads, GetThreads for multi-threaded conversion
+				- SendImage with source pitch - send padded lines directly
+				  with the source line stride, or flip allowing for the pitch
+				- Add SendRGBimage - RGB or BGR pixels expanded to RGBA
+				  directly in the sending buffer
+				- Add SetAlphaMode, GetAlphaMode - premultiply or unpremultiply
+				  in the RGBA copy pass
+				- Add SetSkipUnchanged, GetSkipUnchanged, GetSkippedFrames
+				  Frames are compared by line hashes before conversion
+				  and unchanged frames are sent at the keep-alive interval
+				- Add AcquireFrame, SubmitFrame, CancelFrame, SetFrameBuffers, GetFrameBuffers
+				  Pool of 64 byte aligned buffers owned by the sender
+				  for async sending without a copy
+				- Add SetSendThread, GetSendThread, GetDroppedFrames
+				  Frames queued for a background send thread so that
+				  clocked video does not wait in the caller's thread
+				- Add SendVideoFrame for metadata and video frame submit
+				  common to all send functions
+				- Conversion buffer p_frame from a grow-only page aligned
+				  buffer instead of malloc and free for each size change
+				- Add SetConvertBuffer, GetConvertBufferSize, GetConvertBufferPeak
+				- Metadata attached to the video frame instead of
+				  a separate metadata frame for every video frame
+				- Add SetMetadataMode, GetMetadataMode, QueueMetadata
+				- Add SetConnectionGate, GetConnectionGate, GetGatedFrames, GateFrame
+				  Connections polled by a background thread. Frames are not
+				  converted or sent while there are no receivers.
+				- Add ConvertYUV for RGBA to UYVY or UYVA conversion
+				  used by SendImage and SendRGBimage
+				- ConvertYUV - alpha for each line in the YUV conversion pass
+				  Remove m_alphaBuffer
+				- SendRGBimage - RGB to UYVY or UYVA in one pass. Remove m_rgbaBuffer
+				- AcquireFrame with overflow_block - release the last async frame
+				  if all other buffers are acquired and the send thread is idle
 
 */
 #include "ofxNDIsend.h"
@@ -133,6 +176,32 @@ ofxNDIsend::ofxNDIsend()
 	m_bAsync = false;
 	m_bMetadata = false;
 	m_Format = NDIlib_FourCC_video_type_RGBA; // Default output format
+	m_ColorMatrix = matrix_auto; // BT.601, BT.709 or BT.2020 depending on width
+	m_AlphaMode = alpha_none;
+	m_bSkipUnchanged = false;
+	m_KeepAlive = 1000;
+	m_SkippedFrames = 0;
+	m_LastOptions = 0;
+	m_MetadataMode = metadata_per_frame;
+	m_nFrameMetadata = 0;
+	m_bGate = false;
+	m_GateInterval = 500;
+	m_Connections = 0;
+	m_GatedFrames = 0;
+	m_bGateOpen = true;
+	m_bGateStop = false;
+	m_nFrameBuffers = 3;
+	m_FrameWidth = m_FrameHeight = 0;
+	m_FrameFormat = NDIlib_FourCC_video_type_RGBA;
+	m_FramePitch = 0;
+	m_FrameSize = 0;
+	m_QueueDepth = 0;
+	m_QueueHead = 0;
+	m_QueueTail = 0;
+	m_Overflow = overflow_drop_oldest;
+	m_DroppedFrames = 0;
+	m_bThreadBusy = false;
+	m_bThreadStop = false;
 	m_bNDIinitialized = false;
 	m_Width = m_Height = 0;
 	bSenderInitialized = false;
@@ -162,6 +231,10 @@ ofxNDIsend::~ofxNDIsend()
 		ReleaseSender();
 	bSenderInitialized = false;
 
+	// Stop the send thread and connection thread if started
+	StopSendThread();
+	StopConnectionGate();
+
 	// Library is released in ofxNDIdynloader
 	m_bNDIinitialized = false;
 
@@ -233,10 +306,13 @@ bool ofxNDIsend::CreateSender(const char *sendername, unsigned int width, unsign
 		type += "             serial=\"none\"/>";
 		NDI_connection_type.p_data = (char *)type.c_str();
 		p_NDILib->send_add_connection_metadata(pNDI_send, &NDI_connection_type);
+
+		// Kept to add again if connection metadata is changed
+		m_ProductMetadata = type;
+		m_ConnectionMetadata.clear();
+		SendConnectionMetadata();
 		
 		// Create an non-interlaced frame at 60fps
-		if(p_frame) free((void *)p_frame);
-		p_frame = nullptr; // invert  buffer
 
 		// Dimensions
 		video_frame.xres = (int)width;
@@ -279,6 +355,10 @@ bool ofxNDIsend::CreateSender(const char *sendername, unsigned int width, unsign
 		m_Height = height;
 		bSenderInitialized = true;
 
+		// Poll connections if sending is gated
+		if (m_bGate)
+			StartConnectionGate();
+
 		if(m_bAudio) {
 			// Describe the audio frame
 			// NDIlib_audio_frame_v3_t
@@ -305,6 +385,9 @@ bool ofxNDIsend::UpdateSender(unsigned int width, unsigned int height)
 	if (width == 0 || height == 0)
 		return false;
 
+	// Send frames queued for the send thread
+	FlushSendThread(false);
+
 	if(pNDI_send && m_bAsync) {
 		// NDI documentation :
 		// Because one buffer is in flight we need to make sure that 
@@ -315,9 +398,8 @@ bool ofxNDIsend::UpdateSender(unsigned int width, unsigned int height)
 		p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
 	}
 
-	// Free the local invert buffer, it is re-created in SendImage if invert is needed
-	if(p_frame) free((void *)p_frame);
-	p_frame = nullptr;
+	// The conversion buffer is kept for the new size.
+	// It only grows if the new size is larger than any before.
 	video_frame.p_data = nullptr;
 
 	// Update the sender dimensions
@@ -374,34 +456,45 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 		return false;
 
 	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
+
+		// No receivers connected
+		if (GateFrame())
+			return true;
+
 		// Allow for forgotten UpdateSender
 		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
 			video_frame.xres = (int)width;
 			video_frame.yres = (int)height;
 			video_frame.FourCC = m_Format;
 			SetVideoStride(m_Format);
-			// Release pframe because the size is different
-			// It will be re-created at the correct size
-			if (p_frame) free((void *)p_frame);
-			p_frame = nullptr;
 		}
 
-		if (bSwapRB || bInvert) {
-			// Local memory buffer is only needed for rgba to bgra or invert
+		// Unchanged frame within the keep-alive interval
+		if (SkipFrame(pixels, width*4, height, width*4, bSwapRB, bInvert))
+			return true;
+
+		if (m_Format == NDIlib_FourCC_video_type_UYVY || m_Format == NDIlib_FourCC_video_type_UYVA) {
+			// Convert RGBA or BGRA to UYVY or UYVA in the local buffer
+			if (!ConvertYUV(pixels, width, height, width*4, bSwapRB, bInvert))
+				return false;
+		}
+		else if (bSwapRB || bInvert || m_AlphaMode != alpha_none) {
+			// Local memory buffer is only needed for rgba to bgra, invert or alpha
+			p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, (size_t)width * (size_t)height * 4);
 			if (!p_frame) {
-				p_frame = (uint8_t*)malloc((size_t)width * (size_t)height * 4L * sizeof(unsigned char));
-				if (!p_frame) {
-					printf("ofxNDIsend::SendImage - Out of memory\n");
-					return false;
-				}
-				video_frame.p_data = p_frame;
+				printf("ofxNDIsend::SendImage - Out of memory\n");
+				return false;
 			}
-			ofxNDIutils::CopyImage((const unsigned char *)pixels, (unsigned char *)video_frame.p_data,
-				width, height, (unsigned int)video_frame.line_stride_in_bytes, bSwapRB, bInvert);
+			video_frame.p_data = p_frame;
+			video_frame.line_stride_in_bytes = (int)width * 4;
+			// Swap, flip and alpha in one pass
+			ofxNDIutils::CopyImage((const void *)pixels, (void *)video_frame.p_data,
+				width, height, width*4, width*4, bInvert, bSwapRB, m_AlphaMode);
 		}
 		else {
 			// No bgra conversion or invert, so use the pointer directly
 			video_frame.p_data = (uint8_t*)pixels;
+			video_frame.line_stride_in_bytes = (int)width * 4;
 			// For debugging
 			// FourCC = 1498831189 (YVYU)
 			// FourCC = 1094862674 (ABGR)
@@ -413,32 +506,8 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 		// SendAudio is a separate function and can be called
 		// independently of SendImage
 
-		// Metadata
-		if (m_bMetadata && !m_metadataString.empty()) {
-			metadata_frame.length = (int)m_metadataString.size();
-			metadata_frame.timecode = NDIlib_send_timecode_synthesize;
-			metadata_frame.p_data = (char *)m_metadataString.c_str(); // XML message format
-			p_NDILib->send_send_metadata(pNDI_send, &metadata_frame);
-		}
-
-		if (m_bAsync) {
-			// Submit the video frame asynchronously.
-			// This means that this call will return immediately
-			// and the API will "own" the memory location until there is
-			// a synchronizing event. A synchronizing event is one of : 
-			//  - NDIlib_send_send_video_async
-			//  - NDIlib_send_send_video, NDIlib_send_destroy.
-			// NDIlib_send_send_video_async_v2 will wait for the previous frame to finish
-			// before submitting the current one.
-			p_NDILib->send_send_video_async_v2(pNDI_send, &video_frame);
-		}
-		else {
-			// Submit the video frame. Note that this call will be clocked
-			// so that we end up submitting at exactly the predetermined fps.
-			p_NDILib->send_send_video_v2(pNDI_send, &video_frame);
-		}
-
-		return true;
+		// Metadata and video frame
+		return SendVideoFrame();
 	}
 
 	return false;
@@ -469,67 +538,383 @@ bool ofxNDIsend::SendImage(const unsigned char * pixels,
 	if (!m_bNDIinitialized)
 		return false;
 
+	if (sourcePitch == 0)
+		sourcePitch = width * 4;
+
 	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
 
+		// No receivers connected
+		if (GateFrame())
+			return true;
+
 		// Allow for forgotten UpdateSender
 		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
 			video_frame.xres = (int)width;
 			video_frame.yres = (int)height;
 			video_frame.FourCC = m_Format;
 			SetVideoStride(m_Format);
-			// Free pframe for invert because the size is different
-			// It is re-created in SendImage if invert is needed
-			if (p_frame) free((void *)p_frame);
-			p_frame = nullptr;
 		}
 
-		if (bInvert) {
-			// Local memory buffer is only needed for invert
+		// Unchanged frame within the keep-alive interval
+		if (SkipFrame(pixels, width*4, height, sourcePitch, false, bInvert))
+			return true;
+
+		if (m_Format == NDIlib_FourCC_video_type_UYVY || m_Format == NDIlib_FourCC_video_type_UYVA) {
+			// Convert RGBA to UYVY or UYVA in the local buffer
+			if (!ConvertYUV(pixels, width, height, sourcePitch, false, bInvert))
+				return false;
+		}
+		else if (bInvert || m_AlphaMode != alpha_none) {
+			// Local memory buffer is only needed for invert or alpha
+			p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, (size_t)width * (size_t)height * 4);
 			if (!p_frame) {
-				p_frame = (uint8_t*)malloc((size_t)sourcePitch * (size_t)height * sizeof(unsigned char));
-				if (!p_frame) {
-					printf("ofxNDIsend::SendImage - Out of memory\n");
-					return false;
-				}
+				printf("ofxNDIsend::SendImage - Out of memory\n");
+				return false;
 			}
-			// Flip from the sending buffer to the invert buffer
-			ofxNDIutils::FlipBuffer(pixels, p_frame, width, height);
+			// Flip and alpha from the padded sending buffer to the local buffer
+			ofxNDIutils::CopyImage((const void *)pixels, (void *)p_frame, width, height,
+				sourcePitch, width*4, bInvert, false, m_AlphaMode);
 			// Use the invert buffer as the source of video data
 			video_frame.p_data = (uint8_t*)p_frame;
+			video_frame.line_stride_in_bytes = (int)width * 4;
 		}
 		else {
 			// No invert, so use the source pointer directly
+			// with the source line pitch
 			video_frame.p_data = (uint8_t*)pixels;
+			video_frame.line_stride_in_bytes = (int)sourcePitch;
 		}
 
 		// SendAudio is a separate function and can be called
 		// independently of SendImage
 
-		// Metadata
-		if (m_bMetadata && !m_metadataString.empty()) {
-			metadata_frame.length = (int)m_metadataString.size();
-			metadata_frame.timecode = NDIlib_send_timecode_synthesize;
-			metadata_frame.p_data = (char *)m_metadataString.c_str(); // XML message format
-			p_NDILib->send_send_metadata(pNDI_send, &metadata_frame);
+		// Metadata and video frame
+		return SendVideoFrame();
+	}
+
+	return false;
+}
+
+// Send UYVY pixels already converted from RGBA
+// - image   : UYVY pixel data, (width+1)/2*4 bytes per line
+// - width   : image width
+// - height  : image height
+// - bInvert : flip the image - default false
+bool ofxNDIsend::SendYUVimage(const unsigned char * pixels,
+	unsigned int width, unsigned int height, bool bInvert)
+{
+	if (!m_bNDIinitialized || m_Format != NDIlib_FourCC_video_type_UYVY)
+		return false;
+
+	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
+
+		// No receivers connected
+		if (GateFrame())
+			return true;
+
+		// Allow for forgotten UpdateSender
+		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
+			video_frame.xres = (int)width;
+			video_frame.yres = (int)height;
+			video_frame.FourCC = m_Format;
+			SetVideoStride(m_Format);
 		}
 
-		if (m_bAsync) {
-			// Submit the video frame asynchronously. 
-			// See comments in SendImage above
-			p_NDILib->send_send_video_async_v2(pNDI_send, &video_frame);
+		// Unchanged frame within the keep-alive interval
+		if (SkipFrame(pixels, ((width+1)/2)*4, height,
+			(unsigned int)video_frame.line_stride_in_bytes, false, bInvert))
+			return true;
+
+		if (bInvert) {
+			p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, (size_t)video_frame.line_stride_in_bytes * (size_t)height);
+			if (!p_frame) {
+				printf("ofxNDIsend::SendYUVimage - Out of memory\n");
+				return false;
+			}
+			// Flip UYVY lines as half width rgba pixels
+			ofxNDIutils::CopyImage((const void *)pixels, (void *)p_frame, (width+1)/2, height,
+				(unsigned int)video_frame.line_stride_in_bytes, (unsigned int)video_frame.line_stride_in_bytes, true);
+			video_frame.p_data = p_frame;
 		}
 		else {
-			// Submit the video frame. Note that this call will be clocked
-			// See comments in SendImage above
-			p_NDILib->send_send_video_v2(pNDI_send, &video_frame);
+			// Use the source pointer directly
+			video_frame.p_data = (uint8_t*)pixels;
 		}
 
-		return true;
+		// Metadata and video frame
+		return SendVideoFrame();
 	}
 
 	return false;
 }
 
+// Send RGB or BGR pixels
+// - image   : pixel data RGB or BGR, 3 bytes per pixel
+// - width   : image width
+// - height  : image height
+// - bSwapRB : BGR source - swap red and blue components
+// - bInvert : flip the image - default false
+// - sourcePitch : source buffer line pitch in bytes (0 for width*3)
+bool ofxNDIsend::SendRGBimage(const unsigned char * pixels,
+	unsigned int width, unsigned int height,
+	bool bSwapRB, bool bInvert, unsigned int sourcePitch)
+{
+	if (!m_bNDIinitialized)
+		return false;
+
+	if (pNDI_send && bSenderInitialized && pixels && width > 0 && height > 0) {
+
+		// No receivers connected
+		if (GateFrame())
+			return true;
+
+		// Unchanged frame within the keep-alive interval
+		if (SkipFrame(pixels, width*3, height, sourcePitch, bSwapRB, bInvert))
+			return true;
+
+		// Allow for forgotten UpdateSender
+		if (video_frame.xres != (int)width || video_frame.yres != (int)height) {
+			video_frame.xres = (int)width;
+			video_frame.yres = (int)height;
+			video_frame.FourCC = m_Format;
+			SetVideoStride(m_Format);
+		}
+
+		if (m_Format == NDIlib_FourCC_video_type_UYVY || m_Format == NDIlib_FourCC_video_type_UYVA) {
+			// Convert to UYVY or UYVA in the local buffer
+			// Each line is expanded to RGBA in a line buffer
+			// with red/blue swap and invert in the same pass
+			if (!ConvertYUV(pixels, width, height, sourcePitch, bSwapRB, bInvert, true))
+				return false;
+		}
+		else {
+			// Expand RGB to RGBA directly in the sending buffer
+			// with red/blue swap and invert in the same pass
+			p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, (size_t)width * (size_t)height * 4);
+			if (!p_frame) {
+				printf("ofxNDIsend::SendRGBimage - Out of memory\n");
+				return false;
+			}
+			ofxNDIutils::rgb2rgba(pixels, p_frame, width, height, bInvert, sourcePitch, width*4, bSwapRB);
+			video_frame.p_data = p_frame;
+			video_frame.line_stride_in_bytes = (int)width * 4;
+		}
+
+		// Metadata and video frame
+		return SendVideoFrame();
+	}
+
+	return false;
+}
+
+// Get a frame buffer for the sender size and output format
+// - pitch | receives the line pitch in bytes
+unsigned char *ofxNDIsend::AcquireFrame(unsigned int &pitch)
+{
+	pitch = 0;
+	if (!m_bNDIinitialized || !pNDI_send || !bSenderInitialized)
+		return nullptr;
+
+	// Line pitch and size of the video frame for the output format
+	const unsigned int width  = (unsigned int)video_frame.xres;
+	const unsigned int height = (unsigned int)video_frame.yres;
+	unsigned int linebytes = width*4;
+	size_t size = (size_t)linebytes * (size_t)height;
+	if (m_Format == NDIlib_FourCC_video_type_UYVY || m_Format == NDIlib_FourCC_video_type_UYVA) {
+		linebytes = ((width + 1)/2)*4;
+		size = (size_t)linebytes * (size_t)height;
+		if (m_Format == NDIlib_FourCC_video_type_UYVA)
+			size += size/2;
+	}
+
+	// Queued frames, one being sent, one in use by NDI
+	// after an async send and one for the application
+	unsigned int nBuffers = m_nFrameBuffers;
+	if (m_SendThread.joinable())
+		nBuffers = std::max(nBuffers, m_QueueDepth + 3);
+
+	// Re-create the buffers for a change of size or format
+	if (width != m_FrameWidth || height != m_FrameHeight || m_Format != m_FrameFormat
+		|| m_FrameBuffers.size() != nBuffers) {
+		ReleaseFrameBuffers();
+		m_FrameBuffers.resize(nBuffers);
+		for (framebuffer &fb : m_FrameBuffers) {
+			fb.memory.resize(size + 63);
+			fb.data = reinterpret_cast<unsigned char *>(
+				(reinterpret_cast<uintptr_t>(fb.memory.data()) + 63) & ~(uintptr_t)63);
+		}
+		m_FrameWidth = width;
+		m_FrameHeight = height;
+		m_FrameFormat = m_Format;
+		m_FramePitch = linebytes;
+		m_FrameSize = size;
+	}
+
+	framebuffer *fb = FindFrame(nullptr, 0);
+	if (!fb && m_SendThread.joinable() && m_Overflow == overflow_block) {
+		// Wait for the send thread to free a buffer
+		// or to finish with the queue
+		std::unique_lock<std::mutex> lock(m_QueueMutex);
+		m_FrameDone.wait(lock, [&] {
+			fb = FindFrame(nullptr, 0);
+			return fb || (m_QueueHead.load() == m_QueueTail.load() && !m_bThreadBusy);
+		});
+		if (!fb && (fb = FindFrame(nullptr, 2)) != nullptr) {
+			// The last async frame is in use by NDI until another is sent.
+			// The thread is idle, so release the frame here.
+			p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
+			fb->state = 0;
+		}
+	}
+	if (!fb) {
+		printf("ofxNDIsend::AcquireFrame - all frame buffers are in use\n");
+		return nullptr;
+	}
+	fb->state = 1;
+	pitch = m_FramePitch;
+	return fb->data;
+}
+
+// Send a frame buffer from AcquireFrame
+bool ofxNDIsend::SubmitFrame(unsigned char *frame)
+{
+	if (!m_bNDIinitialized || !pNDI_send || !bSenderInitialized || !frame)
+		return false;
+
+	framebuffer *fb = FindFrame(frame, 1);
+	if (!fb) {
+		printf("ofxNDIsend::SubmitFrame - not an acquired frame buffer\n");
+		return false;
+	}
+
+	// Buffers from before a change of size or format
+	if (video_frame.xres != (int)m_FrameWidth || video_frame.yres != (int)m_FrameHeight
+		|| m_Format != m_FrameFormat) {
+		printf("ofxNDIsend::SubmitFrame - sender size or format has changed\n");
+		fb->state = 0;
+		return false;
+	}
+
+	// No receivers connected
+	if (GateFrame()) {
+		fb->state = 0;
+		return true;
+	}
+
+	// Unchanged frame within the keep-alive interval
+	// UYVA is hashed as lines of the alpha plane pitch
+	const bool bUYVA = (m_Format == NDIlib_FourCC_video_type_UYVA);
+	if (SkipFrame(frame, bUYVA ? m_FramePitch/2 : m_FramePitch, bUYVA ? m_FrameHeight*3 : m_FrameHeight,
+		0, false, false)) {
+		fb->state = 0;
+		return true;
+	}
+
+	// Queued without a copy for the send thread
+	if (m_SendThread.joinable())
+		return QueueFrame(fb);
+
+	video_frame.FourCC = m_Format;
+	video_frame.line_stride_in_bytes = (int)m_FramePitch;
+	video_frame.p_data = frame;
+	SendVideoFrame();
+
+	// Any previous async frame is now free.
+	// An async frame is in use by NDI until the next frame is sent.
+	for (framebuffer &b : m_FrameBuffers) {
+		if (b.state == 2)
+			b.state = 0;
+	}
+	fb->state = m_bAsync ? 2 : 0;
+
+	return true;
+}
+
+// Return a frame buffer from AcquireFrame without sending it
+void ofxNDIsend::CancelFrame(unsigned char *frame)
+{
+	framebuffer *fb = FindFrame(frame, 1);
+	if (fb)
+		fb->state = 0;
+}
+
+// Set the number of frame buffers
+void ofxNDIsend::SetFrameBuffers(unsigned int nBuffers)
+{
+	// Re-created by AcquireFrame
+	m_nFrameBuffers = std::max(2u, nBuffers);
+}
+
+// Get the number of frame buffers
+unsigned int ofxNDIsend::GetFrameBuffers()
+{
+	return m_nFrameBuffers;
+}
+
+// Send frames from a background thread
+// - bThread | start or stop the send thread
+// - depth | number of frames queued
+// - overflow | when the queue is full
+void ofxNDIsend::SetSendThread(bool bThread, unsigned int depth, ofxNDIoverflow overflow)
+{
+	StopSendThread();
+	// Re-created by AcquireFrame for the queue depth
+	ReleaseFrameBuffers();
+	if (!bThread)
+		return;
+
+	m_QueueDepth = std::max(1u, depth);
+	m_Overflow = overflow;
+	m_Queue.reset(new std::atomic<framebuffer *>[m_QueueDepth]);
+	m_QueueHead = 0;
+	m_QueueTail = 0;
+	m_bThreadStop = false;
+	m_SendThread = std::thread(&ofxNDIsend::SendThread, this);
+}
+
+// Get whether frames are sent by a background thread
+bool ofxNDIsend::GetSendThread()
+{
+	return m_SendThread.joinable();
+}
+
+// Number of frames dropped by a full send queue
+unsigned int ofxNDIsend::GetDroppedFrames()
+{
+	return m_DroppedFrames;
+}
+
+// Conversion buffer options
+// - bHugePages | large or transparent huge pages if available
+// - bPrefault | fault in pages when allocated
+// - reserve | bytes to allocate now, for example for the largest expected size
+void ofxNDIsend::SetConvertBuffer(bool bHugePages, bool bPrefault, size_t reserve)
+{
+	// The buffer may be in use by NDI after an async send
+	FlushSendThread(false);
+	if (pNDI_send && m_bAsync)
+		p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
+
+	ofxNDIutils::ReleaseBuffer(m_ConvertBuffer);
+	p_frame = nullptr;
+	m_ConvertBuffer.bHugePages = bHugePages;
+	m_ConvertBuffer.bPrefault = bPrefault;
+	if (reserve > 0)
+		p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, reserve);
+}
+
+// Conversion buffer capacity in bytes
+size_t ofxNDIsend::GetConvertBufferSize()
+{
+	return m_ConvertBuffer.capacity;
+}
+
+// Largest conversion buffer size requested in bytes
+size_t ofxNDIsend::GetConvertBufferPeak()
+{
+	return m_ConvertBuffer.peak;
+}
+
 // Close sender and release resources
 void ofxNDIsend::ReleaseSender()
 {
@@ -537,12 +922,21 @@ void ofxNDIsend::ReleaseSender()
 
 	if (!m_bNDIinitialized) return;
 
+	// Discard frames queued for the send thread
+	FlushSendThread(true);
+
+	// Stop polling connections before the sender is destroyed
+	StopConnectionGate();
+
 	// Clear metadata
 	if (m_bMetadata && !m_metadataString.empty()) {
 		p_NDILib->send_clear_connection_metadata(pNDI_send);
 		m_metadataString.clear();
 	}
 	m_bMetadata = false;
+	m_LastMetadata.clear();
+	m_ConnectionMetadata.clear();
+	m_MetadataEvents.clear();
 
 	// Destroy the NDI sender
 	if (pNDI_send) {
@@ -554,11 +948,19 @@ void ofxNDIsend::ReleaseSender()
 		m_Width = m_Height = 0;
 	}
 
-	// Release the invert buffer
-	if (p_frame)
-		free((void*)p_frame);
+	// Release the conversion buffer
+	ofxNDIutils::ReleaseBuffer(m_ConvertBuffer);
 	p_frame = nullptr;
 
+	// Release frame buffers after the sender is destroyed
+	ReleaseFrameBuffers();
+
+	// Reset change detection and queue counts
+	m_LastHash.clear();
+	m_SkippedFrames = 0;
+	m_DroppedFrames = 0;
+	m_GatedFrames = 0;
+
 	// Reset sender dimensions
 	m_Width = m_Height = 0;
 
@@ -576,6 +978,47 @@ int ofxNDIsend::GetConnections(uint32_t msec_timeout)
 	return p_NDILib->send_get_no_connections(pNDI_send, msec_timeout);
 }
 
+// Skip sending while there are no receivers
+// - bGate | poll connections and gate frames
+// - interval | poll interval in milliseconds while connected
+void ofxNDIsend::SetConnectionGate(bool bGate, unsigned int interval)
+{
+	StopConnectionGate();
+	m_bGate = bGate;
+	m_GateInterval = std::max(1u, interval);
+	if (m_bGate && bSenderInitialized)
+		StartConnectionGate();
+}
+
+// Get whether sending is gated by connections
+bool ofxNDIsend::GetConnectionGate()
+{
+	return m_bGate;
+}
+
+// Number of frames not sent because there were no receivers
+unsigned int ofxNDIsend::GetGatedFrames()
+{
+	return m_GatedFrames;
+}
+
+// Return true if a frame should not be sent because there are no receivers.
+// The frame is counted as gated. Call before any conversion or readback.
+bool ofxNDIsend::GateFrame()
+{
+	if (!m_GateThread.joinable())
+		return false;
+
+	const bool bOpen = (m_Connections.load() > 0);
+	if (!bOpen)
+		m_GatedFrames++;
+	else if (!m_bGateOpen)
+		m_LastHash.clear(); // Send the first frame for a new receiver
+	m_bGateOpen = bOpen;
+
+	return !bOpen;
+}
+
 // Return current sender width
 unsigned int ofxNDIsend::GetWidth()
 {
@@ -613,10 +1056,15 @@ std::string ofxNDIsend::GetNDIname()
 // Set video frame format
 //  Default NDIlib_FourCC_video_type_RGBA
 //  Can be NDIlib_FourCC_video_type_BGRA to match texture format
-//  NDIlib_FourCC_video_type_UYVY with OpenFrameworks shaders only
+//  NDIlib_FourCC_video_type_UYVY - RGBA pixels are converted by SendImage
+//  NDIlib_FourCC_video_type_UYVA - as for UYVY with an alpha plane
 void ofxNDIsend::SetFormat(NDIlib_FourCC_video_type_e format)
 {
 	m_Format = format;
+	// Buffer size and line stride change between YUV and RGBA
+	// Update the video frame if the sender has been created
+	if (bSenderInitialized)
+		UpdateSender(m_Width, m_Height);
 	// For debugging
 	// NDI_LIB_FOURCC(ch0, ch1, ch2, ch3)
 	// ((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) | ((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24))
@@ -631,6 +1079,65 @@ NDIlib_FourCC_video_type_e ofxNDIsend::GetFormat()
 	return m_Format;
 }
 
+// Set color matrix for RGBA to UYVY conversion
+void ofxNDIsend::SetColorMatrix(ofxNDIcolormatrix matrix)
+{
+	m_ColorMatrix = matrix;
+}
+
+// Get color matrix for RGBA to UYVY conversion
+ofxNDIcolormatrix ofxNDIsend::GetColorMatrix()
+{
+	return m_ColorMatrix;
+}
+
+// Set alpha conversion of sent pixels
+void ofxNDIsend::SetAlphaMode(ofxNDIalphamode mode)
+{
+	m_AlphaMode = mode;
+}
+
+// Get alpha conversion of sent pixels
+ofxNDIalphamode ofxNDIsend::GetAlphaMode()
+{
+	return m_AlphaMode;
+}
+
+// Set the number of threads for pixel conversion
+void ofxNDIsend::SetThreads(unsigned int nThreads)
+{
+	ofxNDIutils::SetThreadCount(nThreads);
+}
+
+// Get the number of threads for pixel conversion
+unsigned int ofxNDIsend::GetThreads()
+{
+	return ofxNDIutils::GetThreadCount();
+}
+
+// Skip frames that have not changed since the last frame sent
+// - bSkip | compare each frame with the last frame sent
+// - keepalive | milliseconds before an unchanged frame is sent again
+void ofxNDIsend::SetSkipUnchanged(bool bSkip, unsigned int keepalive)
+{
+	m_bSkipUnchanged = bSkip;
+	m_KeepAlive = keepalive;
+	// The next frame is sent
+	m_LastHash.clear();
+}
+
+// Get whether unchanged frames are skipped
+bool ofxNDIsend::GetSkipUnchanged()
+{
+	return m_bSkipUnchanged;
+}
+
+// Number of unchanged frames skipped since the sender was created
+unsigned int ofxNDIsend::GetSkippedFrames()
+{
+	return m_SkippedFrames;
+}
+
 // Set frame rate - frames per second whole number
 void ofxNDIsend::SetFrameRate(int framerate)
 {
@@ -926,12 +1433,41 @@ bool ofxNDIsend::SendAudio()
 void ofxNDIsend::SetMetadata(bool bMetadata)
 {
 	m_bMetadata = bMetadata;
+	SendConnectionMetadata();
 }
 
 // Set metadata
 void ofxNDIsend::SetMetadataString(std::string datastring)
 {
+	// Send the next frame with the new metadata
+	if (datastring != m_metadataString)
+		m_LastHash.clear();
 	m_metadataString = datastring;
+	SendConnectionMetadata();
+}
+
+// Set how the metadata string is sent
+void ofxNDIsend::SetMetadataMode(ofxNDImetadatamode mode)
+{
+	FlushSendThread(false);
+	m_MetadataMode = mode;
+	// Send again in the new mode
+	m_LastMetadata.clear();
+	m_LastHash.clear();
+	SendConnectionMetadata();
+}
+
+// Get how the metadata string is sent
+ofxNDImetadatamode ofxNDIsend::GetMetadataMode()
+{
+	return m_MetadataMode;
+}
+
+// Queue a metadata event to be sent before the next video frame
+void ofxNDIsend::QueueMetadata(std::string datastring, int64_t timecode)
+{
+	if (!datastring.empty())
+		m_MetadataEvents.emplace_back(std::move(datastring), timecode);
 }
 
 // Get the current NDI SDK version
@@ -953,12 +1489,432 @@ std::string ofxNDIsend::GetNDIversion()
 void ofxNDIsend::SetVideoStride(NDIlib_FourCC_video_type_e format)
 {
 	// Stop async send before changing the video frame
+	FlushSendThread(false);
 	if (pNDI_send && m_bAsync)
 		p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
-	if (format == NDIlib_FourCC_video_type_UYVY)
-		video_frame.line_stride_in_bytes = video_frame.xres * 2;
+	if (format == NDIlib_FourCC_video_type_UYVY || format == NDIlib_FourCC_video_type_UYVA)
+		video_frame.line_stride_in_bytes = ((video_frame.xres + 1) / 2) * 4; // xres*2 for even width
 	else
 		video_frame.line_stride_in_bytes = video_frame.xres * 4;
 }
 
+// Return true if the frame is the same as the last frame sent
+// and the keep-alive interval has not elapsed.
+// Line hashes are compared with those of the last frame.
+// Conversion options are part of the frame.
+bool ofxNDIsend::SkipFrame(const unsigned char *pixels, unsigned int linebytes, unsigned int height,
+	unsigned int pitch, bool bSwapRB, bool bInvert)
+{
+	if (!m_bSkipUnchanged)
+		return false;
+
+	// Queued metadata events are sent with the next frame
+	if (!m_MetadataEvents.empty())
+		m_LastHash.clear();
+
+	m_LineHash.resize(height);
+	ofxNDIutils::HashLines(pixels, linebytes, height, pitch, m_LineHash.data());
+
+	const uint64_t options = ((uint64_t)m_Format << 32) | ((uint64_t)m_ColorMatrix << 8)
+		| ((uint64_t)m_AlphaMode << 4) | ((uint64_t)bSwapRB << 1) | (uint64_t)bInvert;
+	const bool bUnchanged = (options == m_LastOptions && m_LineHash == m_LastHash);
+	m_LastHash.swap(m_LineHash);
+	m_LastOptions = options;
+
+	const auto now = std::chrono::steady_clock::now();
+	if (bUnchanged && (m_KeepAlive == 0
+		|| now - m_LastSendTime < std::chrono::milliseconds(m_KeepAlive))) {
+		m_SkippedFrames++;
+		return true;
+	}
+	m_LastSendTime = now;
+	return false;
+}
+
+// Frame buffer with the given state
+// and frame pointer or the first with that state
+ofxNDIsend::framebuffer *ofxNDIsend::FindFrame(unsigned char *frame, int state)
+{
+	for (framebuffer &fb : m_FrameBuffers) {
+		if (fb.state == state && (!frame || fb.data == frame))
+			return &fb;
+	}
+	return nullptr;
+}
+
+// Free the frame buffers after NDI has finished with them
+void ofxNDIsend::ReleaseFrameBuffers()
+{
+	FlushSendThread(false);
+	if (pNDI_send && FindFrame(nullptr, 2)) {
+		// Wait for the frame in use (see UpdateSender)
+		p_NDILib->send_send_video_async_v2(pNDI_send, nullptr);
+		video_frame.p_data = nullptr;
+	}
+	m_FrameBuffers.clear();
+	m_FrameWidth = m_FrameHeight = 0;
+	m_FramePitch = 0;
+	m_FrameSize = 0;
+}
+
+// Convert RGBA or BGRA pixels to UYVY or UYVA in the local buffer
+// for the video frame. Alpha conversion is applied to each line if set.
+// - sourcePitch | source line pitch in bytes
+// - bRGB | RGB or BGR source pixels, 3 bytes per pixel
+bool ofxNDIsend::ConvertYUV(const unsigned char *rgba, unsigned int width, unsigned int height,
+	unsigned int sourcePitch, bool bSwapRB, bool bInvert, bool bRGB)
+{
+	p_frame = ofxNDIutils::ReserveBuffer(m_ConvertBuffer, GetVideoSize());
+	if (!p_frame) {
+		printf("ofxNDIsend::ConvertYUV - Out of memory\n");
+		return false;
+	}
+	// RGB lines are expanded to RGBA in the conversion pass
+	if (bRGB)
+		ofxNDIutils::RGB_to_YUV422(rgba, p_frame, width, height, sourcePitch, bSwapRB, bInvert, 0, m_ColorMatrix,
+			m_Format == NDIlib_FourCC_video_type_UYVA);
+	// Alpha for each line in the conversion pass
+	else if (m_Format == NDIlib_FourCC_video_type_UYVA)
+		ofxNDIutils::RGBA_to_UYVA(rgba, p_frame, width, height, sourcePitch, bSwapRB, bInvert, 0, m_ColorMatrix, m_AlphaMode);
+	else
+		ofxNDIutils::RGBA_to_YUV422(rgba, p_frame, width, height, sourcePitch, bSwapRB, bInvert, 0, m_ColorMatrix, m_AlphaMode);
+	video_frame.p_data = p_frame;
+	return true;
+}
+
+// Send the video frame and metadata
+// With the send thread, a copy is queued
+bool ofxNDIsend::SendVideoFrame()
+{
+	if (m_SendThread.joinable()) {
+		// The source is not a frame buffer
+		// and is not changed if the buffers are re-created
+		const uint8_t *source = video_frame.p_data;
+		const size_t stride = (size_t)video_frame.line_stride_in_bytes;
+		unsigned int pitch = 0;
+		unsigned char *frame = AcquireFrame(pitch);
+		if (!frame || !source)
+			return false;
+		// Copy lines allowing for the source line stride
+		// and the UYVA alpha plane of half the stride
+		for (unsigned int y = 0; y < m_FrameHeight; y++)
+			memcpy(frame + (size_t)y*pitch, source + y*stride, pitch);
+		if (m_FrameFormat == NDIlib_FourCC_video_type_UYVA) {
+			const uint8_t *alpha = source + stride*m_FrameHeight;
+			unsigned char *alphadest = frame + (size_t)pitch*m_FrameHeight;
+			for (unsigned int y = 0; y < m_FrameHeight; y++)
+				memcpy(alphadest + (size_t)y*(pitch/2), alpha + y*(stride/2), pitch/2);
+		}
+		return QueueFrame(FindFrame(frame, 1));
+	}
+
+	// Metadata events before the frame
+	SendMetadataEvents();
+
+	// Metadata
+	video_frame.p_metadata = nullptr;
+	if (m_bMetadata && !m_metadataString.empty()) {
+		if (m_MetadataMode == metadata_per_frame) {
+			// Attached to the video frame. Copies alternate because
+			// an async frame is in use by NDI until the next is sent.
+			std::string &data = m_FrameMetadata[m_nFrameMetadata++ & 1];
+			data = m_metadataString;
+			video_frame.p_metadata = data.c_str();
+		}
+		else if (m_MetadataMode == metadata_on_change && m_metadataString != m_LastMetadata) {
+			metadata_frame.length = (int)m_metadataString.size();
+			metadata_frame.timecode = NDIlib_send_timecode_synthesize;
+			metadata_frame.p_data = (char *)m_metadataString.c_str(); // XML message format
+			p_NDILib->send_send_metadata(pNDI_send, &metadata_frame);
+			m_LastMetadata = m_metadataString;
+		}
+	}
+
+	if (m_bAsync) {
+		// Submit the video frame asynchronously.
+		// This means that this call will return immediately
+		// and the API will "own" the memory location until there is
+		// a synchronizing event. A synchronizing event is one of : 
+		//  - NDIlib_send_send_video_async
+		//  - NDIlib_send_send_video, NDIlib_send_destroy.
+		// NDIlib_send_send_video_async_v2 will wait for the previous frame to finish
+		// before submitting the current one.
+		p_NDILib->send_send_video_async_v2(pNDI_send, &video_frame);
+	}
+	else {
+		// Submit the video frame. Note that this call will be clocked
+		// so that we end up submitting at exactly the predetermined fps.
+		p_NDILib->send_send_video_v2(pNDI_send, &video_frame);
+	}
+
+	return true;
+}
+
+// Send queued metadata events in order
+void ofxNDIsend::SendMetadataEvents()
+{
+	for (auto &event : m_MetadataEvents) {
+		NDIlib_metadata_frame_t metadata;
+		metadata.length = (int)event.first.size();
+		metadata.timecode = event.second;
+		metadata.p_data = (char *)event.first.c_str();
+		p_NDILib->send_send_metadata(pNDI_send, &metadata);
+	}
+	m_MetadataEvents.clear();
+}
+
+// Add the metadata string to the connection metadata if it has changed.
+// Connection metadata is cleared and the sender identification added again.
+void ofxNDIsend::SendConnectionMetadata()
+{
+	if (!m_bNDIinitialized || !pNDI_send)
+		return;
+
+	std::string data;
+	if (m_bMetadata && m_MetadataMode == metadata_connection)
+		data = m_metadataString;
+	if (data == m_ConnectionMetadata)
+		return;
+
+	NDIlib_metadata_frame_t metadata;
+	metadata.length = 0;
+	metadata.timecode = NDIlib_send_timecode_synthesize;
+	p_NDILib->send_clear_connection_metadata(pNDI_send);
+	metadata.p_data = (char *)m_ProductMetadata.c_str();
+	p_NDILib->send_add_connection_metadata(pNDI_send, &metadata);
+	if (!data.empty()) {
+		metadata.length = (int)data.size();
+		metadata.p_data = (char *)data.c_str();
+		p_NDILib->send_add_connection_metadata(pNDI_send, &metadata);
+	}
+	m_ConnectionMetadata = data;
+}
+
+// Start the connection thread for the sender
+void ofxNDIsend::StartConnectionGate()
+{
+	if (m_GateThread.joinable() || !pNDI_send)
+		return;
+	// Current count for the first frame
+	m_Connections = p_NDILib->send_get_no_connections(pNDI_send, 0);
+	m_bGateOpen = true;
+	m_bGateStop = false;
+	m_GateThread = std::thread(&ofxNDIsend::ConnectionThread, this);
+}
+
+// Stop the connection thread
+void ofxNDIsend::StopConnectionGate()
+{
+	if (!m_GateThread.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> lock(m_GateMutex);
+		m_bGateStop = true;
+	}
+	m_GateWake.notify_one();
+	m_GateThread.join();
+}
+
+// Poll the number of connections
+void ofxNDIsend::ConnectionThread()
+{
+	std::unique_lock<std::mutex> lock(m_GateMutex);
+	while (!m_bGateStop) {
+		lock.unlock();
+		// With no connections, NDI waits for the first one so that
+		// sending resumes without waiting for the poll interval.
+		// The wait is limited so that the thread can be stopped.
+		const uint32_t timeout = (m_Connections.load() > 0) ? 0 : std::min(m_GateInterval, 100u);
+		m_Connections = p_NDILib->send_get_no_connections(pNDI_send, timeout);
+		lock.lock();
+		if (m_Connections.load() > 0)
+			m_GateWake.wait_for(lock, std::chrono::milliseconds(m_GateInterval), [&] { return m_bGateStop; });
+	}
+}
+
+//
+// Send thread
+//
+// The caller's thread queues frame buffers and the send thread
+// submits them to NDI. The queue is a ring of frame buffer pointers.
+// Head is only changed by the caller and tail by compare and swap,
+// so that the caller can also remove the oldest frame if the queue
+// is full. The mutex and condition variables are only used to wait.
+//
+
+// Queue a frame buffer for the send thread
+bool ofxNDIsend::QueueFrame(framebuffer *fb)
+{
+	if (!fb)
+		return false;
+
+	// Metadata events are sent now rather than with the queued frame
+	// so that they are not lost if the frame is dropped.
+	SendMetadataEvents();
+
+	// Video frame and metadata for the send thread
+	fb->frame = video_frame;
+	fb->frame.xres = (int)m_FrameWidth;
+	fb->frame.yres = (int)m_FrameHeight;
+	fb->frame.FourCC = m_FrameFormat;
+	fb->frame.line_stride_in_bytes = (int)m_FramePitch;
+	fb->frame.p_data = fb->data;
+	fb->frame.p_metadata = nullptr;
+	fb->metadata.clear();
+	if (m_bMetadata && m_MetadataMode != metadata_connection)
+		fb->metadata = m_metadataString;
+	// Per frame metadata is attached, otherwise sent on change by the thread
+	if (m_MetadataMode == metadata_per_frame && !fb->metadata.empty())
+		fb->frame.p_metadata = fb->metadata.c_str();
+	fb->bAsync = m_bAsync;
+
+	unsigned int head = m_QueueHead.load(std::memory_order_relaxed);
+	for (;;) {
+		unsigned int tail = m_QueueTail.load(std::memory_order_acquire);
+		if (head - tail < m_QueueDepth)
+			break;
+		if (m_Overflow == overflow_drop_newest) {
+			fb->state = 0;
+			m_DroppedFrames++;
+			return true;
+		}
+		if (m_Overflow == overflow_drop_oldest) {
+			// Remove the oldest unless the send thread takes it first
+			framebuffer *oldest = m_Queue[tail % m_QueueDepth].load(std::memory_order_relaxed);
+			if (m_QueueTail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+				oldest->state = 0;
+				m_DroppedFrames++;
+			}
+			continue;
+		}
+		// Wait for the send thread to take a frame
+		std::unique_lock<std::mutex> lock(m_QueueMutex);
+		m_FrameDone.wait(lock, [&] { return head - m_QueueTail.load() < m_QueueDepth; });
+	}
+
+	fb->state = 3;
+	m_Queue[head % m_QueueDepth].store(fb, std::memory_order_relaxed);
+	m_QueueHead.store(head + 1, std::memory_order_release);
+
+	// Wake the send thread
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+	}
+	m_FrameReady.notify_one();
+
+	return true;
+}
+
+// Take the oldest frame from the queue
+ofxNDIsend::framebuffer *ofxNDIsend::PopFrame()
+{
+	unsigned int tail = m_QueueTail.load(std::memory_order_relaxed);
+	for (;;) {
+		if (tail == m_QueueHead.load(std::memory_order_acquire))
+			return nullptr;
+		framebuffer *fb = m_Queue[tail % m_QueueDepth].load(std::memory_order_relaxed);
+		// tail is updated if the caller has removed the frame
+		if (m_QueueTail.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+			return fb;
+	}
+}
+
+// Wait for queued frames to be sent, or discard them
+void ofxNDIsend::FlushSendThread(bool bDiscard)
+{
+	if (!m_SendThread.joinable())
+		return;
+
+	if (bDiscard) {
+		while (framebuffer *fb = PopFrame())
+			fb->state = 0;
+	}
+
+	std::unique_lock<std::mutex> lock(m_QueueMutex);
+	m_FrameDone.wait(lock, [&] {
+		return m_QueueHead.load() == m_QueueTail.load() && !m_bThreadBusy;
+	});
+}
+
+// Stop the thread and discard queued frames
+void ofxNDIsend::StopSendThread()
+{
+	if (!m_SendThread.joinable())
+		return;
+
+	FlushSendThread(true);
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		m_bThreadStop = true;
+	}
+	m_FrameReady.notify_one();
+	m_SendThread.join();
+}
+
+// Send thread function
+void ofxNDIsend::SendThread()
+{
+	for (;;) {
+		// Busy before the queue is checked
+		// so that FlushSendThread waits for a frame being taken
+		m_bThreadBusy = true;
+		framebuffer *fb = PopFrame();
+		if (!fb) {
+			std::unique_lock<std::mutex> lock(m_QueueMutex);
+			m_bThreadBusy = false;
+			m_FrameDone.notify_all();
+			m_FrameReady.wait(lock, [&] {
+				return m_bThreadStop || m_QueueHead.load() != m_QueueTail.load();
+			});
+			if (m_bThreadStop)
+				return;
+			continue;
+		}
+
+		// Space in the queue
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+		}
+		m_FrameDone.notify_all();
+
+		fb->state = 2;
+		if (!fb->frame.p_metadata && !fb->metadata.empty() && fb->metadata != m_LastMetadata) {
+			NDIlib_metadata_frame_t metadata;
+			metadata.length = (int)fb->metadata.size();
+			metadata.timecode = NDIlib_send_timecode_synthesize;
+			metadata.p_data = (char *)fb->metadata.c_str();
+			p_NDILib->send_send_metadata(pNDI_send, &metadata);
+			m_LastMetadata = fb->metadata;
+		}
+
+		// Clocked video waits here rather than in the caller's thread
+		if (fb->bAsync)
+			p_NDILib->send_send_video_async_v2(pNDI_send, &fb->frame);
+		else
+			p_NDILib->send_send_video_v2(pNDI_send, &fb->frame);
+
+		// Any previous async frame is now free
+		{
+			std::lock_guard<std::mutex> lock(m_QueueMutex);
+			for (framebuffer &b : m_FrameBuffers) {
+				if (&b != fb && b.state == 2)
+					b.state = 0;
+			}
+			if (!fb->bAsync)
+				fb->state = 0;
+		}
+		m_FrameDone.notify_all();
+	}
+}
+
+// Size in bytes of the video frame data.
+// UYVA has an alpha plane of half the UYVY line stride.
+size_t ofxNDIsend::GetVideoSize()
+{
+	size_t size = (size_t)video_frame.line_stride_in_bytes * (size_t)video_frame.yres;
+	if (video_frame.FourCC == NDIlib_FourCC_video_type_UYVA)
+		size += size / 2;
+	return size;
+}
+
 
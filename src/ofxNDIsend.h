@@ -42,6 +42,17 @@
 	15.11.19 - Change to dynamic load of Newtek NDI dlls
 	19.01.25 - Update to NDI 6.1.1.0
 	20.12.25 - Update to NDI version 6.2.1.0
+	17.10.26 - Add SendYUVimage, SetColorMatrix, GetColorMatrix
+			 - UYVA output format
+			 - Add SetThreads, GetThreads
+			 - Add SendRGBimage
+			 - Add SetAlphaMode, GetAlphaMode
+			 - Add SetSkipUnchanged, GetSkipUnchanged, GetSkippedFrames
+			 - Add AcquireFrame, SubmitFrame, CancelFrame, SetFrameBuffers, GetFrameBuffers
+			 - Add SetSendThread, GetSendThread, GetDroppedFrames and ofxNDIoverflow
+			 - Add SetConvertBuffer, GetConvertBufferSize, GetConvertBufferPeak
+			 - Add ofxNDImetadatamode, SetMetadataMode, GetMetadataMode, QueueMetadata
+			 - Add SetConnectionGate, GetConnectionGate, GetGatedFrames, GateFrame
 
 */
 #pragma once
@@ -51,7 +62,15 @@
 #include <stdio.h>
 #include <string>
 #include <map> // for std::map
+#include <vector> // for std::vector
 #include <numeric>  // for std::gcd
+#include <chrono>   // for the keep-alive interval
+#include <list>     // for frame buffers
+#include <memory>   // for std::unique_ptr
+#include <thread>   // for the send thread
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "ofxNDIdynloader.h" // NDI library loader
 #include "ofxNDIutils.h" // buffer copy utilities
@@ -67,6 +86,20 @@
 #endif
 
 
+// Send thread queue full
+enum ofxNDIoverflow {
+	overflow_drop_oldest = 0, // Replace the oldest queued frame
+	overflow_drop_newest = 1, // Do not queue the new frame
+	overflow_block = 2        // Wait for the send thread
+};
+
+// How the metadata string is sent
+enum ofxNDImetadatamode {
+	metadata_per_frame  = 0, // Attached to each video frame
+	metadata_on_change  = 1, // Separate metadata frame when the string changes
+	metadata_connection = 2  // Connection metadata, sent to each new receiver
+};
+
 class ofxNDIsend {
 
 public:
@@ -86,6 +119,7 @@ public:
 	bool UpdateSender(unsigned int width, unsigned int height);
 
 	// Send image pixels
+	// Pixels are converted to YUV if the output format is UYVY or UYVA
 	// - image | pixel data BGRA or RGBA
 	// - width | image width
 	// - height | image height
@@ -102,15 +136,108 @@ public:
 	bool SendImage(const unsigned char *image, unsigned int width, unsigned int height,	bool bInvert = false);
 
 	// Send image pixels allowing for source buffer pitch
+	// Pixels are converted to YUV if the output format is UYVY or UYVA
 	// - image | pixel data BGRA or RGBA
 	// - width | image width
 	// - height | image height
-	// - pitch | source buffer pitch
+	// - pitch | source buffer line pitch in bytes (0 for width*4)
+	//           Padded lines are sent directly or flipped without a compaction copy
 	// - bInvert | flip the image - default false
 	bool SendImage(const unsigned char *image,
 		unsigned int width, unsigned int height, 
 		unsigned int sourcePitch, bool bInvert = false);
 
+	// Send UYVY pixels already converted from RGBA
+	// For UYVY output format only
+	// - image | UYVY pixel data, (width+1)/2*4 bytes per line
+	// - width | image width
+	// - height | image height
+	// - bInvert | flip the image - default false
+	bool SendYUVimage(const unsigned char *image,
+		unsigned int width, unsigned int height, bool bInvert = false);
+
+	// Send RGB or BGR pixels without a separate RGBA copy
+	// Pixels are expanded to RGBA in the sending buffer,
+	// or converted to YUV if the output format is UYVY or UYVA
+	// - image | pixel data RGB or BGR, 3 bytes per pixel
+	// - width | image width
+	// - height | image height
+	// - bSwapRB | BGR source - swap red and blue components - default false
+	// - bInvert | flip the image - default false
+	// - sourcePitch | source buffer line pitch in bytes (0 for width*3)
+	bool SendRGBimage(const unsigned char *image,
+		unsigned int width, unsigned int height,
+		bool bSwapRB = false, bool bInvert = false, unsigned int sourcePitch = 0);
+
+	// Sender frame buffers for sending without a copy
+	// A frame is written directly to a buffer from AcquireFrame
+	// in the output format and sent by SubmitFrame.
+	// Buffers are 64 byte aligned and are re-used only after NDI
+	// has finished with them, so that async sending needs no copy
+	// and the application does not manage buffer lifetime.
+	// Buffers acquired before a change of sender size or format are not sent.
+
+	// Get a frame buffer for the sender size and output format
+	// RGBA or BGRA - width*4 bytes per line
+	// UYVY - (width+1)/2*4 bytes per line
+	// UYVA - UYVY lines followed by an alpha plane of half the line pitch
+	// - pitch | receives the line pitch in bytes
+	// Returns nullptr if the sender is not created or all buffers are in use
+	unsigned char *AcquireFrame(unsigned int &pitch);
+
+	// Send a frame buffer from AcquireFrame
+	// The buffer must not be used after it is submitted.
+	bool SubmitFrame(unsigned char *frame);
+
+	// Return a frame buffer from AcquireFrame without sending it
+	void CancelFrame(unsigned char *frame);
+
+	// Set the number of frame buffers
+	// One may be in use by NDI and one by the application, 
+	// so 2 is the minimum and the third allows the next frame
+	// to be acquired before the last is submitted.
+	// Initialized 3
+	void SetFrameBuffers(unsigned int nBuffers = 3);
+
+	// Get the number of frame buffers
+	unsigned int GetFrameBuffers();
+
+	// Send frames from a background thread
+	// Frames are queued for a thread that sends them to NDI,
+	// so that the send functions return without waiting for clocked video.
+	// SendImage, SendYUVimage and SendRGBimage copy the frame to a sender
+	// frame buffer. Frames from AcquireFrame are queued without a copy.
+	// The number of frame buffers is at least the queue depth plus three.
+	// - bThread | start or stop the send thread
+	// - depth | number of frames queued, 1 or more
+	// - overflow | when the queue is full
+	//     overflow_drop_oldest - replace the oldest queued frame
+	//     overflow_drop_newest - do not queue the new frame
+	//     overflow_block - wait for the send thread
+	// Initialized false
+	void SetSendThread(bool bThread = true, unsigned int depth = 2,
+		ofxNDIoverflow overflow = overflow_drop_oldest);
+
+	// Get whether frames are sent by a background thread
+	bool GetSendThread();
+
+	// Number of frames dropped by a full send queue
+	unsigned int GetDroppedFrames();
+
+	// Conversion buffer options
+	// The buffer is re-used for any size up to its capacity,
+	// so changes of sender size do not re-allocate once it has grown.
+	// - bHugePages | large or transparent huge pages if available
+	// - bPrefault | fault in pages when allocated rather than on first use
+	// - reserve | bytes to allocate now (default none)
+	void SetConvertBuffer(bool bHugePages = false, bool bPrefault = false, size_t reserve = 0);
+
+	// Conversion buffer capacity in bytes
+	size_t GetConvertBufferSize();
+
+	// Largest conversion buffer size requested in bytes
+	size_t GetConvertBufferPeak();
+
 	// Close sender and release resources
 	void ReleaseSender();
 
@@ -120,6 +247,23 @@ public:
 	// Return the number of receiver connections
 	int GetConnections(uint32_t msec_timeout);
 
+	// Skip sending while there are no receivers
+	// Connections are polled by a background thread while the sender exists.
+	// Frames are not converted or sent until the first connection.
+	// - interval | poll interval in milliseconds while connected
+	// Initialized false
+	void SetConnectionGate(bool bGate = true, unsigned int interval = 500);
+
+	// Get whether sending is gated by connections
+	bool GetConnectionGate();
+
+	// Number of frames not sent because there were no receivers
+	unsigned int GetGatedFrames();
+
+	// Return true if a frame should not be sent because there are no receivers
+	// For a caller to skip readback or conversion before sending
+	bool GateFrame();
+
 	// Return current sender width
 	unsigned int GetWidth();
 
@@ -138,6 +282,52 @@ public:
 	// Get output format
 	NDIlib_FourCC_video_type_e GetFormat();
 
+	// Set color matrix for RGBA to UYVY conversion
+	// Initialized matrix_auto
+	// BT.601 for width less than 720, BT.709 less than 3840, otherwise BT.2020
+	void SetColorMatrix(ofxNDIcolormatrix matrix = matrix_auto);
+
+	// Get color matrix for RGBA to UYVY conversion
+	ofxNDIcolormatrix GetColorMatrix();
+
+	// Set alpha conversion of sent pixels
+	// alpha_premultiply - straight to premultiplied
+	// alpha_unpremultiply - premultiplied to straight
+	// Initialized alpha_none
+	void SetAlphaMode(ofxNDIalphamode mode = alpha_none);
+
+	// Get alpha conversion of sent pixels
+	ofxNDIalphamode GetAlphaMode();
+
+	// Set the number of threads for pixel conversion
+	// 0 - number of processor cores, 1 - single threaded (default)
+	// Frames from 1280x720 are divided between threads
+	// (see ofxNDIutils::SetThreadCount and SetThreadMinimum).
+	// The threads are shared by all senders and receivers.
+	void SetThreads(unsigned int nThreads);
+
+	// Get the number of threads for pixel conversion
+	unsigned int GetThreads();
+
+	// Skip frames that have not changed since the last frame sent
+	// For static content such as slates, scoreboards and idle displays.
+	// Each frame is compared with the last by a hash of each line (ofxNDIutils::HashLines)
+	// before conversion. An unchanged frame is not converted or sent
+	// and the send functions return true immediately, without waiting
+	// for clocked video. Changes of format, alpha mode, colour matrix,
+	// swap, invert or metadata string are sent as a changed frame.
+	// - bSkip | compare each frame with the last frame sent
+	// - keepalive | milliseconds before an unchanged frame is sent again
+	//               0 - unchanged frames are not sent
+	// Initialized false, keep-alive 1000 msec
+	void SetSkipUnchanged(bool bSkip = true, unsigned int keepalive = 1000);
+
+	// Get whether unchanged frames are skipped
+	bool GetSkipUnchanged();
+
+	// Number of unchanged frames skipped since the sender was created
+	unsigned int GetSkippedFrames();
+
 	// Set frame rate
 	// - framerate - frames per second
 	// Initialized 60fps
@@ -247,6 +437,18 @@ public:
 	// - datastring | XML message format string NULL terminated
 	void SetMetadataString(std::string datastring);
 
+	// Set how the metadata string is sent
+	// Initialized metadata_per_frame
+	void SetMetadataMode(ofxNDImetadatamode mode);
+
+	// Get how the metadata string is sent
+	ofxNDImetadatamode GetMetadataMode();
+
+	// Queue a metadata event to be sent before the next video frame
+	// - datastring | XML message format string
+	// - timecode | 100ns units (default synthesized by NDI)
+	void QueueMetadata(std::string datastring, int64_t timecode = NDIlib_send_timecode_synthesize);
+
 	// Get the current NDI SDK version
 	std::string GetNDIversion();
 
@@ -263,7 +465,8 @@ private:
 	NDIlib_send_create_t NDI_send_create_desc;
 	NDIlib_send_instance_t pNDI_send;
 	NDIlib_video_frame_v2_t video_frame;
-	uint8_t* p_frame;
+	uint8_t* p_frame; // Conversion buffer for the current frame
+	ofxNDIbuffer m_ConvertBuffer; // Grow-only memory for p_frame
 
 	// Sender dimensions
 	unsigned int m_Width, m_Height;
@@ -279,7 +482,60 @@ private:
 	bool m_bClockVideo; // Clock video flag
 	bool m_bAsync; // NDI asynchronous sender
 	NDIlib_FourCC_video_type_e m_Format; // Output format. Default RGBA. May also be BGRA or YUV.
+	ofxNDIcolormatrix m_ColorMatrix; // RGBA to UYVY conversion matrix
+	ofxNDIalphamode m_AlphaMode; // Premultiply or unpremultiply sent pixels
+	bool m_bSkipUnchanged; // Skip frames that have not changed
+	unsigned int m_KeepAlive; // Milliseconds before an unchanged frame is sent again
+	unsigned int m_SkippedFrames; // Number of unchanged frames skipped
+	std::vector<uint64_t> m_LineHash; // Line hashes of the current frame
+	std::vector<uint64_t> m_LastHash; // Line hashes of the last frame sent
+	uint64_t m_LastOptions; // Conversion options of the last frame sent
+	std::chrono::steady_clock::time_point m_LastSendTime; // Time the last frame was sent
+	bool SkipFrame(const unsigned char *pixels, unsigned int linebytes, unsigned int height,
+		unsigned int pitch, bool bSwapRB, bool bInvert); // Unchanged frame within the keep-alive
+
+	// Frame buffers for AcquireFrame, SubmitFrame and the send thread
+	struct framebuffer {
+		std::vector<unsigned char> memory; // Allocation allowing for alignment
+		unsigned char *data = nullptr; // 64 byte aligned frame
+		std::atomic<int> state{0}; // 0 free, 1 acquired, 2 in use by NDI, 3 queued
+		NDIlib_video_frame_v2_t frame; // Video frame sent by the send thread
+		std::string metadata; // Metadata attached to the frame or sent on change by the send thread
+		bool bAsync = false; // Sent asynchronously by the send thread
+	};
+	std::list<framebuffer> m_FrameBuffers; // List for fixed addresses
+	unsigned int m_nFrameBuffers; // Number of frame buffers
+	unsigned int m_FrameWidth, m_FrameHeight; // Frame buffer dimensions
+	NDIlib_FourCC_video_type_e m_FrameFormat; // Frame buffer format
+	unsigned int m_FramePitch; // Line pitch of the frame buffers
+	size_t m_FrameSize; // Bytes in each frame buffer
+	framebuffer *FindFrame(unsigned char *frame, int state); // Buffer of a frame pointer
+	void ReleaseFrameBuffers(); // Wait for NDI and free the buffers
+	bool SendVideoFrame(); // Send video_frame and metadata or queue a copy
+	bool ConvertYUV(const unsigned char *rgba, unsigned int width, unsigned int height,
+		unsigned int sourcePitch, bool bSwapRB, bool bInvert, bool bRGB = false); // RGBA or RGB to UYVY or UYVA in p_frame
+
+	// Send thread and single producer, single consumer queue
+	// The producer may also remove the oldest frame for overflow_drop_oldest
+	std::thread m_SendThread;
+	std::unique_ptr<std::atomic<framebuffer *>[]> m_Queue; // Ring of queued frames
+	unsigned int m_QueueDepth; // Ring size
+	std::atomic<unsigned int> m_QueueHead; // Frames queued (producer)
+	std::atomic<unsigned int> m_QueueTail; // Frames taken from the queue
+	ofxNDIoverflow m_Overflow; // Queue full policy
+	unsigned int m_DroppedFrames; // Frames dropped by a full queue
+	std::mutex m_QueueMutex; // For waiting only
+	std::condition_variable m_FrameReady; // A frame has been queued
+	std::condition_variable m_FrameDone; // A frame has been taken or sent
+	std::atomic<bool> m_bThreadBusy; // Send thread is taking or sending a frame
+	bool m_bThreadStop; // Stop the send thread
+	bool QueueFrame(framebuffer *fb); // Queue a frame buffer for the send thread
+	framebuffer *PopFrame(); // Take the oldest frame from the queue
+	void FlushSendThread(bool bDiscard); // Wait for queued frames to be sent or discard them
+	void StopSendThread(); // Stop the thread and discard queued frames
+	void SendThread(); // Send thread function
 	void SetVideoStride(NDIlib_FourCC_video_type_e format); // Set line stride for YUV or RGBA
+	size_t GetVideoSize(); // Video frame data size in bytes
 
 	// Audio
 	bool m_bAudio;
@@ -297,6 +553,29 @@ private:
 	bool m_bMetadata;
 	NDIlib_metadata_frame_t metadata_frame; // The frame that will be sent
 	std::string m_metadataString; // XML message format string NULL terminated - application provided
+	ofxNDImetadatamode m_MetadataMode; // Per frame, on change or connection
+	std::string m_FrameMetadata[2]; // Alternate copies attached to async frames
+	unsigned int m_nFrameMetadata; // Copy used for the next frame
+	std::string m_LastMetadata; // Last string sent on change
+	std::string m_ProductMetadata; // Sender identification connection metadata
+	std::string m_ConnectionMetadata; // Application string added to the connection
+	std::vector<std::pair<std::string, int64_t>> m_MetadataEvents; // Queued events and timecodes
+	void SendMetadataEvents();
+	void SendConnectionMetadata();
+
+	// Connection gate
+	bool m_bGate; // Frames are not sent without connections
+	unsigned int m_GateInterval; // Poll interval in milliseconds
+	std::atomic<int> m_Connections; // Last number of connections polled
+	unsigned int m_GatedFrames; // Frames not sent without connections
+	bool m_bGateOpen; // Connections for the last frame
+	std::thread m_GateThread;
+	std::mutex m_GateMutex;
+	std::condition_variable m_GateWake;
+	bool m_bGateStop;
+	void StartConnectionGate();
+	void StopConnectionGate();
+	void ConnectionThread();
 
 };
 
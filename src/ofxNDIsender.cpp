@@ -109,6 +109,23 @@
 			   Revise error messages in SetFormat and ReadYUVpixels
 	16.08-26 - Add GetConnections - number of receiver connections
 	18.08.26 - SetFormat - add printf error message if shader path not found
+	17.10.26 - SetFormat - UYVY without the rgba2yuv shader uses CPU conversion
+			   SendImage pixels - allow UYVY format (converted by ofxNDIsend)
+			   SendImage texture - UYVY from the shader sent by SendYUVimage
+			 - SetFormat - UYVA with alpha plane converted by the CPU
+			 - SendImage ofPixels and ofImage - RGB or BGR pixels sent by
+			   SendRGBimage without conversion of the image type
+			 - Add SetAlphaMode, GetAlphaMode
+			 - Add SetSkipUnchanged, GetSkipUnchanged, GetSkippedFrames
+			 - Add AcquireFrame, SubmitFrame, CancelFrame, SetFrameBuffers
+			 - Add SetSendThread, GetSendThread, GetDroppedFrames
+			 - Add SetConvertBuffer, GetConvertBufferSize, GetConvertBufferPeak
+			 - Add SetMetadataMode, GetMetadataMode, QueueMetadata
+			 - Add SetConnectionGate, GetConnectionGate, GetGatedFrames
+			   SendImage texture, ofImage and ofPixels - return before
+			   readback or conversion if there are no receivers
+			 - SendImage texture - read (width+1)/2 UYVY macropixels from the
+			   shader to match the sender line stride for odd width
 
 */
 #include "ofxNDIsender.h"
@@ -177,7 +194,7 @@ bool ofxNDIsender::CreateSender(const char *sendername, unsigned int width, unsi
 	ndiFbo.allocate(width, height, GL_RGBA);
 
 	// Allocata yuv texture half width
-	m_yuvtexture.allocate(width/2, height, GL_RGBA);
+	m_yuvtexture.allocate((width+1)/2, height, GL_RGBA);
 
 	if (NDIsender.CreateSender(sendername, width, height)) {
 		m_SenderName = sendername;
@@ -212,7 +229,7 @@ bool ofxNDIsender::UpdateSender(unsigned int width, unsigned int height)
 	// Re-allocate utility fbo
 	ndiFbo.allocate(width, height, GL_RGBA);
 	// Re-allocata yuv texture half width
-	m_yuvtexture.allocate(width/2, height, GL_RGBA);
+	m_yuvtexture.allocate((width+1)/2, height, GL_RGBA);
 
 	// Update NDI video frame
 	return NDIsender.UpdateSender(width, height);
@@ -251,6 +268,24 @@ int ofxNDIsender::GetConnections(uint32_t msec_timeout) {
 	return NDIsender.GetConnections(msec_timeout);
 }
 
+// Skip sending while there are no receivers
+void ofxNDIsender::SetConnectionGate(bool bGate, unsigned int interval)
+{
+	NDIsender.SetConnectionGate(bGate, interval);
+}
+
+// Get whether sending is gated by connections
+bool ofxNDIsender::GetConnectionGate()
+{
+	return NDIsender.GetConnectionGate();
+}
+
+// Number of frames not sent because there were no receivers
+unsigned int ofxNDIsender::GetGatedFrames()
+{
+	return NDIsender.GetGatedFrames();
+}
+
 // Return current sender width
 unsigned int ofxNDIsender::GetWidth()
 {
@@ -290,6 +325,10 @@ bool ofxNDIsender::SendImage(ofTexture tex, bool bInvert) {
 		return false;
 	}
 
+	// No receivers connected - skip readback and conversion
+	if (NDIsender.GateFrame())
+		return true;
+
 	// Quit if the texture is not RGBA, RGBA8, BGRA, RGB or BGR
 	if (!(tex.getTextureData().glInternalFormat  == GL_RGBA    // 0x1908
 		|| tex.getTextureData().glInternalFormat == GL_RGBA8   // 0x8058
@@ -317,12 +356,18 @@ bool ofxNDIsender::SendImage(ofTexture tex, bool bInvert) {
 	// Read texture pixels into a pixel buffer
 	bool bResult = false;
 	// NDIlib_FourCC_video_type_UYVY is enabled by SetFormat
-	if (NDIsender.GetFormat() == NDIlib_FourCC_video_type_UYVY) {
+	if (NDIsender.GetFormat() == NDIlib_FourCC_video_type_UYVY && m_bYUVshader) {
 		// Both tex and ndiBuffer are allocated full width
 		// Sender YUV output width is half that of the RGBA input
-		bResult = ReadYUVpixels(tex, width/2, height, ndiBuffer[m_idx]);
+		// (width+1)/2 macropixels to match the sender line stride for odd width
+		bResult = ReadYUVpixels(tex, (width+1)/2, height, ndiBuffer[m_idx]);
+		// Send the converted UYVY data
+		if (bResult)
+			return NDIsender.SendYUVimage((const unsigned char*)ndiBuffer[m_idx].getData(), width, height, bInvert);
+		return false;
 	}
 	else {
+		// RGBA pixels are converted by SendImage for UYVY or UYVA format
 		bResult = ReadPixels(tex, width, height, ndiBuffer[m_idx]);
 	}
 
@@ -342,17 +387,22 @@ bool ofxNDIsender::SendImage(ofImage &img, bool bSwapRB, bool bInvert)
 	// Not initialized of image not allocated
 	if (!NDIsender.SenderCreated() || !img.isAllocated())
 		return false;
+
+	// No receivers connected
+	if (NDIsender.GateFrame())
+		return true;
 	
-	// RGBA for pixels
+	// RGB pixels are sent without conversion of the image type
+	if (!img.isUsingTexture())
+		return SendImage(img.getPixels(), bSwapRB, bInvert);
+
+	// RGBA for the texture
 	if (img.getImageType() != OF_IMAGE_COLOR_ALPHA) {
 		// Conversion from RGB to RGBA adds alpha 255 for each pixel
 		img.setImageType(OF_IMAGE_COLOR_ALPHA);
 	}
 
-	if (img.isUsingTexture())
-		return SendImage(img.getTexture(), bInvert);
-	else
-		return SendImage(img.getPixels(), bSwapRB, bInvert);
+	return SendImage(img.getTexture(), bInvert);
 
 
 }
@@ -364,6 +414,29 @@ bool ofxNDIsender::SendImage(ofPixels &pix, bool bSwapRB, bool bInvert)
 	if (!NDIsender.SenderCreated() || !pix.isAllocated())
 		return false;
 
+	// No receivers connected
+	if (NDIsender.GateFrame())
+		return true;
+
+	// RGB or BGR pixels are expanded to RGBA by the sender
+	// without changing the ofPixels image type
+	if (pix.getNumChannels() == 3) {
+		const unsigned int width  = (unsigned int)pix.getWidth();
+		const unsigned int height = (unsigned int)pix.getHeight();
+		if (!(GetFormat() == NDIlib_FourCC_video_type_RGBA
+		   || GetFormat() == NDIlib_FourCC_video_type_RGBX
+		   || GetFormat() == NDIlib_FourCC_video_type_UYVY
+		   || GetFormat() == NDIlib_FourCC_video_type_UYVA)) {
+			SetFormat(NDIlib_FourCC_video_type_RGBA);
+		}
+		if (width != NDIsender.GetWidth() || height != NDIsender.GetHeight())
+			UpdateSender(width, height);
+		// BGR pixels are swapped unless bSwapRB is also set
+		const bool bBGR = (pix.getPixelFormat() == OF_PIXELS_BGR);
+		return NDIsender.SendRGBimage((const unsigned char *)pix.getData(), width, height,
+			bBGR != bSwapRB, bInvert, (unsigned int)pix.getBytesStride());
+	}
+
 	// RGBA for ofPixels
 	if (pix.getImageType() != OF_IMAGE_COLOR_ALPHA) {
 		pix.setImageType(OF_IMAGE_COLOR_ALPHA);
@@ -383,8 +456,11 @@ bool ofxNDIsender::SendImage(const unsigned char * pixels,
 		return false;
 
 	// NDI format must be set to RGBA to match the pixel data
+	// or UYVY/UYVA for conversion by ofxNDIsend
 	if (!(GetFormat() == NDIlib_FourCC_video_type_RGBA
-	   || GetFormat() == NDIlib_FourCC_video_type_RGBX)) {
+	   || GetFormat() == NDIlib_FourCC_video_type_RGBX
+	   || GetFormat() == NDIlib_FourCC_video_type_UYVY
+	   || GetFormat() == NDIlib_FourCC_video_type_UYVA)) {
 			SetFormat(NDIlib_FourCC_video_type_RGBA);
 	}
 
@@ -398,6 +474,84 @@ bool ofxNDIsender::SendImage(const unsigned char * pixels,
 
 }
 
+// Get a sender frame buffer to write a frame in the output format
+unsigned char *ofxNDIsender::AcquireFrame(unsigned int &pitch)
+{
+	return NDIsender.AcquireFrame(pitch);
+}
+
+// Send a frame buffer from AcquireFrame
+bool ofxNDIsender::SubmitFrame(unsigned char *frame)
+{
+	return NDIsender.SubmitFrame(frame);
+}
+
+// Return a frame buffer from AcquireFrame without sending it
+void ofxNDIsender::CancelFrame(unsigned char *frame)
+{
+	NDIsender.CancelFrame(frame);
+}
+
+// Set the number of sender frame buffers
+void ofxNDIsender::SetFrameBuffers(unsigned int nBuffers)
+{
+	NDIsender.SetFrameBuffers(nBuffers);
+}
+
+// Send frames from a background thread
+void ofxNDIsender::SetSendThread(bool bThread, unsigned int depth, ofxNDIoverflow overflow)
+{
+	NDIsender.SetSendThread(bThread, depth, overflow);
+}
+
+// Get whether frames are sent by a background thread
+bool ofxNDIsender::GetSendThread()
+{
+	return NDIsender.GetSendThread();
+}
+
+// Number of frames dropped by a full send queue
+unsigned int ofxNDIsender::GetDroppedFrames()
+{
+	return NDIsender.GetDroppedFrames();
+}
+
+// Conversion buffer options
+void ofxNDIsender::SetConvertBuffer(bool bHugePages, bool bPrefault, size_t reserve)
+{
+	NDIsender.SetConvertBuffer(bHugePages, bPrefault, reserve);
+}
+
+// Conversion buffer capacity in bytes
+size_t ofxNDIsender::GetConvertBufferSize()
+{
+	return NDIsender.GetConvertBufferSize();
+}
+
+// Largest conversion buffer size requested in bytes
+size_t ofxNDIsender::GetConvertBufferPeak()
+{
+	return NDIsender.GetConvertBufferPeak();
+}
+
+// Set how the metadata string is sent
+void ofxNDIsender::SetMetadataMode(ofxNDImetadatamode mode)
+{
+	NDIsender.SetMetadataMode(mode);
+}
+
+// Get how the metadata string is sent
+ofxNDImetadatamode ofxNDIsender::GetMetadataMode()
+{
+	return NDIsender.GetMetadataMode();
+}
+
+// Queue a metadata event to be sent before the next video frame
+void ofxNDIsender::QueueMetadata(std::string datastring, int64_t timecode)
+{
+	NDIsender.QueueMetadata(datastring, timecode);
+}
+
 // Set output format
 void ofxNDIsender::SetFormat(NDIlib_FourCC_video_type_e format)
 {
@@ -427,24 +581,25 @@ void ofxNDIsender::SetFormat(NDIlib_FourCC_video_type_e format)
 				shaderpath = ofToDataPath("rgba2yuv/GL2/rgba2yuv.frag");
 			#endif
 		}
-		bool bExists = ofFile::doesFileExist(shaderpath, false);
-		if (bExists) {
-			NDIsender.SetFormat(format);
-			// Buffer size will change between YUV and RGBA
-			// Retain sender dimensions, but update the sender
-			// to re-create pbos, buffers and NDI video frame
-			// Update sender if already created (UpdateSender checks)
-			UpdateSender(NDIsender.GetWidth(), NDIsender.GetHeight());
-		}
-		else {
-			printf("ofxNDIsender::SetFormat - could not find shader folder\n%s\n", shaderpath.c_str());
+		m_bYUVshader = ofFile::doesFileExist(shaderpath, false);
+		if (!m_bYUVshader) {
+			// Pixels are converted to UYVY by the CPU
+			printf("ofxNDIsender::SetFormat - could not find shader folder\n%s\nUsing CPU conversion\n", shaderpath.c_str());
 		}
+		NDIsender.SetFormat(format);
+		// Buffer size will change between YUV and RGBA
+		// Retain sender dimensions, but update the sender
+		// to re-create pbos, buffers and NDI video frame
+		// Update sender if already created (UpdateSender checks)
+		UpdateSender(NDIsender.GetWidth(), NDIsender.GetHeight());
 	}
 	else if (format == NDIlib_FourCC_video_type_BGRA
 		  || format == NDIlib_FourCC_video_type_BGRX
 		  || format == NDIlib_FourCC_video_type_RGBA
-		  || format == NDIlib_FourCC_video_type_RGBX) {
+		  || format == NDIlib_FourCC_video_type_RGBX
+		  || format == NDIlib_FourCC_video_type_UYVA) {
 			  // Supported formats
+			  // UYVA is converted from RGBA pixels by the CPU
 			  NDIsender.SetFormat(format);
 			  UpdateSender(NDIsender.GetWidth(), NDIsender.GetHeight());
 	}
@@ -577,6 +732,36 @@ bool ofxNDIsender::GetAsync()
 	return NDIsender.GetAsync();
 }
 
+// Set alpha conversion of sent pixels
+void ofxNDIsender::SetAlphaMode(ofxNDIalphamode mode)
+{
+	NDIsender.SetAlphaMode(mode);
+}
+
+// Get alpha conversion of sent pixels
+ofxNDIalphamode ofxNDIsender::GetAlphaMode()
+{
+	return NDIsender.GetAlphaMode();
+}
+
+// Skip frames that have not changed since the last frame sent
+void ofxNDIsender::SetSkipUnchanged(bool bSkip, unsigned int keepalive)
+{
+	NDIsender.SetSkipUnchanged(bSkip, keepalive);
+}
+
+// Get whether unchanged frames are skipped
+bool ofxNDIsender::GetSkipUnchanged()
+{
+	return NDIsender.GetSkipUnchanged();
+}
+
+// Number of unchanged frames skipped
+unsigned int ofxNDIsender::GetSkippedFrames()
+{
+	return NDIsender.GetSkippedFrames();
+}
+
 // Set asynchronous readback of pixels from FBO or texture
 void ofxNDIsender::SetReadback(bool bReadback)
 {
@@ -801,7 +986,8 @@ bool ofxNDIsender::ReadYUVpixels(ofFbo &fbo, unsigned int halfwidth, unsigned in
 }
 
 // Read yuv pixels from an rgba texture (tex) to a yuv buffer
-// The halfwidth argument is half the sender width
+// The halfwidth argument is half the sender width, (width+1)/2 for odd width
+// The last macropixel of an odd width line repeats the edge pixel
 bool ofxNDIsender::ReadYUVpixels(ofTexture &tex, unsigned int halfwidth, unsigned int height, ofPixels &buffer)
 {
 	if (halfwidth == 0 || height == 0)
@@ -81,6 +81,18 @@ public:
 	// Return the number of receiver connections
 	int GetConnections(uint32_t msec_timeout);
 
+	// Skip sending while there are no receivers
+	// Texture readback, shader conversion and copies are skipped
+	// until the first connection. Connections are polled by a thread.
+	// - interval | poll interval in milliseconds while connected
+	void SetConnectionGate(bool bGate = true, unsigned int interval = 500);
+
+	// Get whether sending is gated by connections
+	bool GetConnectionGate();
+
+	// Number of frames not sent because there were no receivers
+	unsigned int GetGatedFrames();
+
 	// Return current sender width
 	unsigned int GetWidth();
 
@@ -107,12 +119,14 @@ public:
 	// - image   | Openframeworks image to send
 	// - bInvert | flip the image - default false
 	// - image is converted to RGBA if not already
+	//   RGB pixels of an image without texture are sent directly
 	bool SendImage(ofImage &img, bool bSwapRB = false, bool bInvert = false);
 
 	// Send ofPixels
 	// - pix     | Openframeworks pixel buffer to send
 	// - bInvert | flip the image - default false
-	// - pixel buffer is converted to RGBA if not already
+	// - RGB or BGR pixels are expanded to RGBA by the sender,
+	//   other pixel buffers are converted to RGBA if not already
 	bool SendImage(ofPixels &pix, bool bSwapRB = false, bool bInvert = false);
 
 	// Send RGBA image pixels
@@ -124,7 +138,52 @@ public:
 	bool SendImage(const unsigned char *image, unsigned int width, unsigned int height,
 		bool bSwapRB = false, bool bInvert = false);
 
+	// Get a sender frame buffer to write a frame in the output format
+	// 64 byte aligned, sent by SubmitFrame without a copy
+	// (see ofxNDIsend::AcquireFrame)
+	// - pitch | receives the line pitch in bytes
+	unsigned char *AcquireFrame(unsigned int &pitch);
+
+	// Send a frame buffer from AcquireFrame
+	bool SubmitFrame(unsigned char *frame);
+
+	// Return a frame buffer from AcquireFrame without sending it
+	void CancelFrame(unsigned char *frame);
+
+	// Set the number of sender frame buffers, 2 or more
+	// Initialized 3
+	void SetFrameBuffers(unsigned int nBuffers = 3);
+
+	// Send frames from a background thread
+	// Frames are queued and the thread waits for clocked video
+	// - depth | number of frames queued
+	// - overflow | overflow_drop_oldest, overflow_drop_newest or overflow_block
+	void SetSendThread(bool bThread = true, unsigned int depth = 2,
+		ofxNDIoverflow overflow = overflow_drop_oldest);
+
+	// Get whether frames are sent by a background thread
+	bool GetSendThread();
+
+	// Number of frames dropped by a full send queue
+	unsigned int GetDroppedFrames();
+
+	// Conversion buffer options
+	// Grow-only, so changes of sender size do not re-allocate
+	// - bHugePages | large or transparent huge pages if available
+	// - bPrefault | fault in pages when allocated
+	// - reserve | bytes to allocate now (default none)
+	void SetConvertBuffer(bool bHugePages = false, bool bPrefault = false, size_t reserve = 0);
+
+	// Conversion buffer capacity in bytes
+	size_t GetConvertBufferSize();
+
+	// Largest conversion buffer size requested in bytes
+	size_t GetConvertBufferPeak();
+
 	// Set output format
+	// UYVY uses the rgba2yuv shader for textures if found,
+	// otherwise RGBA pixels are converted by the CPU
+	// UYVA (UYVY with alpha) is always converted by the CPU
 	void SetFormat(NDIlib_FourCC_video_type_e format);
 
 	// Get output format
@@ -204,6 +263,28 @@ public:
 	// Get current readback mode
 	bool GetReadback();
 
+	// Set alpha conversion of sent RGBA pixels
+	// alpha_premultiply or alpha_unpremultiply
+	// (not for the UYVY shader)
+	// Initialized alpha_none
+	void SetAlphaMode(ofxNDIalphamode mode = alpha_none);
+
+	// Get alpha conversion
+	ofxNDIalphamode GetAlphaMode();
+
+	// Skip frames that have not changed since the last frame sent
+	// - bSkip | compare each frame with the last frame sent
+	// - keepalive | milliseconds before an unchanged frame is sent again
+	//               0 - unchanged frames are not sent
+	// Initialized false, keep-alive 1000 msec
+	void SetSkipUnchanged(bool bSkip = true, unsigned int keepalive = 1000);
+
+	// Get whether unchanged frames are skipped
+	bool GetSkipUnchanged();
+
+	// Number of unchanged frames skipped
+	unsigned int GetSkippedFrames();
+
 	// Set to send Audio
 	// Initialized false
 	void SetAudio(bool bAudio = true);
@@ -255,6 +336,17 @@ public:
 	// - datastring | XML message format string NULL terminated
 	void SetMetadataString(std::string datastring);
 
+	// Set how the metadata string is sent
+	// metadata_per_frame (default), metadata_on_change or metadata_connection
+	void SetMetadataMode(ofxNDImetadatamode mode);
+
+	// Get how the metadata string is sent
+	ofxNDImetadatamode GetMetadataMode();
+
+	// Queue a metadata event to be sent before the next video frame
+	// - timecode | 100ns units (default synthesized by NDI)
+	void QueueMetadata(std::string datastring, int64_t timecode = NDIlib_send_timecode_synthesize);
+
 	// Get the current NDI SDK version
 	std::string GetNDIversion();
 
@@ -294,6 +386,7 @@ private:
 	ofShader rgba2yuv;      // Openframeworks RGBA to YUV shader
 	ofTexture m_yuvtexture; // for shader RGBA > YUV conversion
 	int m_colormatrix = 1;  // 0 - BT.601, 1 - BT.709, 2 - BT.2020
+	bool m_bYUVshader = false; // rgba2yuv shader found, otherwise CPU conversion
 
 	// Read YUV pixels from RGBA fbo to pixel buffer
 	bool ReadYUVpixels(ofFbo &fbo, unsigned int halfwidth, unsigned int height, ofPixels &buffer);
@@ -70,9 +70,78 @@
 			   from SpoutUtils - SpoutMessageBox
 			   Add MessageDialogCancel to add a caption 'X'
 			   Update ofxNDI version to 2.003.000
+	17.10.26 - YUV422_to_RGBA - SSE2 and AVX2 functions
+			   selected at startup by CPU feature detection.
+			   Scalar version retained as the reference.
+			   Allow for odd width. 1.0 msec at 1920x1080 (AVX2).
+			 - Add GetSIMDsupport, GetSIMDlevel, SetSIMDlevel
+			 - memcpy_sse2, memcpy_movsd, rgba_bgra_sse2 for all platforms
+			   memcpy_sse2 - any alignment and size, sfence after streaming stores
+			   __movsd for OSX/Linux copies DWORDs as for Visual Studio
+			 - Add memcpy_avx2 and rgba_bgra_avx2
+			 - rgba_bgra, FlipBuffer and CopyImage use the SIMD level selected
+			 - Add RGBA_to_YUV422 - BT.601, BT.709, BT.2020
+			   SSE2 and AVX2. 1920x1080 : 14 msec scalar, 3.0 msec SSE2, 1.5 msec AVX2
+			 - Add NV12_to_RGBA and I420_to_RGBA (I420 and YV12)
+			 - Add P216_to_RGBA16 and P216_to_RGBA (P216 and PA16)
+			   16 bit or 8 bit RGBA with optional ordered dither
+			 - Add RGBA_to_UYVA and UYVA_to_RGBA including the alpha plane
+			 - Add worker thread pool for band-parallel conversion
+			   SetThreadCount, GetThreadCount, SetThreadMinimum, GetThreadMinimum
+			 - YUV422_to_RGBA - flip, BGRA output and destination pitch in one pass
+			 - CopyImage with source and destination pitch - option bgra<>rgba
+			 - YUV to RGBA - constexpr BT.601, BT.709 and BT.2020 coefficients
+			   for limited or full range, selected for each call.
+			   Remove global lookup tables.
+			 - Close USE_CHRONO after the timing functions so that the audio
+			   functions are available for all platforms
+			 - Source and destination line pitch for all pixel functions
+			 - rgb2rgba - SSSE3 byte shuffle, option bgr source
+			   Add simd_ssse3 level
+			 - FlipVertical - flip in place without allocation, with line pitch
+			 - Add YUV422_to_RGBA_scaled and ScaleImage - convert and scale in one pass
+			   Box filter for reduction by 2, 4 or 8, otherwise bilinear
+			 - Add ConvertRegion - convert a rectangle of a frame for all received formats
+			   4:2:0 conversion allows for a region origin
+			 - Add PremultiplyAlpha and UnpremultiplyAlpha with swap and flip in the same pass
+			 - Add LoadCubeLUT, CreateLUT1D, CreateLUT3D and ApplyLUT
+			   1D tables and 3D tetrahedral interpolation, AVX2 gather
+			   ConvertRegion - apply the table to each line as it is converted
+			 - Add RGBA_to_Tensor and YUV422_to_Tensor - planar float32 or float16
+			   with mean and std normalization
+			 - Add HashLines - 64 bit hash of each line for change detection
+			 - Add ReserveBuffer and ReleaseBuffer - grow-only page aligned buffer
+			   with optional huge pages and pre-faulting
+			 - SIMD functions selected on first use instead of by a static
+			   initializer, for use during static initialization elsewhere
+			 - Worker threads started by SetThreadCount wait for the next frame
+			 - UYVA_to_RGBA, P216_to_RGBA, ConvertRegion, ScaleImage - add alpha mode
+			   Premultiply or unpremultiply each line after conversion
+			   YUV422_to_RGBA_scaled and ScaleImage - add lut
+			 - RGBA_to_YUV422, RGBA_to_UYVA - add alpha mode for each line
+			 - Lookup table after unpremultiply and before premultiply
+			   RGBA_to_UYVA - alpha plane in the same pass
+			 - Add RGB_to_YUV422 - RGB or BGR to UYVY or UYVA without an RGBA frame copy
 
 */
 #include "ofxNDIutils.h"
+#include <fstream> // for LoadCubeLUT
+#include <sstream>
+#if !defined(TARGET_WIN32)
+#include <sys/mman.h> // for ReserveBuffer
+#include <unistd.h>
+#endif
+
+// Functions using instructions beyond the build target
+// are compiled for that target with GCC and Clang.
+// Visual Studio allows any intrinsic without options.
+#if defined(OFXNDI_X86) && !defined(_MSC_VER)
+#define OFXNDI_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define OFXNDI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define OFXNDI_TARGET_SSSE3
+#define OFXNDI_TARGET_AVX2
+#endif
 
 // _rotl replacement
 // Other solutions possible
@@ -98,13 +167,60 @@ namespace ofxNDIutils {
 	uint32_t PeriodMin = 0;
 #endif
 
-#if defined (__APPLE__)
+	//
+	// SIMD function table
+	//
+	// Line conversion functions for the current SIMD level.
+	// Resolved on first use from the CPU features (see SetSIMDlevel).
+	//
+	struct YUVcoefficients;  // YUV to RGB conversion
+	struct RGBcoefficients;  // RGB to YUV conversion
+	struct P216coefficients; // 16 bit YUV to RGB
+
+	struct ofxNDIkernels {
+		void (*uyvy_rgba)(const unsigned char* yuv, unsigned char* rgba, unsigned int width, const YUVcoefficients &c, bool bSwapRB);
+		void (*rgba_bgra)(const uint32_t* src, uint32_t* dst, unsigned int width);
+		void (*copy)(void* dst, const void* src, size_t Size);
+		void (*rgba_uyvy)(const unsigned char* rgba, unsigned char* yuv, unsigned int width, const RGBcoefficients &c);
+		void (*nv12_uyvy)(const unsigned char* y, const unsigned char* uv, unsigned char* uyvy, unsigned int width);
+		void (*i420_uyvy)(const unsigned char* y, const unsigned char* u, const unsigned char* v, unsigned char* uyvy, unsigned int width);
+		void (*p216_rgba16)(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha, uint16_t* rgba, unsigned int width, const P216coefficients &c);
+		void (*p216_rgba8)(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha, unsigned char* rgba, unsigned int width, const P216coefficients &c, const float* dither);
+		void (*rgba_alpha)(const unsigned char* rgba, unsigned char* alpha, unsigned int width);
+		void (*alpha_rgba)(const unsigned char* alpha, unsigned char* rgba, unsigned int width);
+		void (*rgb_rgba)(const unsigned char* rgb, unsigned char* rgba, unsigned int width, bool bSwapRB);
+		void (*swap_rows)(unsigned char* a, unsigned char* b, size_t bytes);
+		void (*vsum_rows)(const unsigned char* src, size_t stride, unsigned int rows, uint16_t* sum, size_t bytes);
+		void (*lerp_rows)(const unsigned char* a, const unsigned char* b, unsigned char* dst, size_t bytes, int w);
+		void (*uyvy_box_reduce)(uint16_t* sum, unsigned int macropixels);
+		void (*rgba_box_reduce)(uint16_t* sum, unsigned int pixels);
+		void (*box_pack)(const uint16_t* sum, unsigned char* dst, size_t n, unsigned int shift);
+		void (*premultiply)(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB);
+		void (*unpremultiply)(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB);
+		void (*lut_rgba)(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width);
+		void (*rgba_planar)(const unsigned char* rgba, float* const* planes, unsigned int width, const float* scale, const float* bias);
+		void (*rgba_planar16)(const unsigned char* rgba, uint16_t* const* planes, unsigned int width, const uint16_t* half);
+		uint64_t (*hash_row)(const unsigned char* src, size_t bytes);
+	};
+	static ofxNDIkernels simdkernels{}; // Set by SetSIMDlevel
+	static ofxNDIsimd simdlevel = simd_none;
+
+	// The functions are selected on first use rather than by a static
+	// initializer, so that pixel conversion can be used during static
+	// initialization in other translation units.
+	static const ofxNDIkernels &Kernels()
+	{
+		static const bool bSelected = simdkernels.copy || (SetSIMDlevel(GetSIMDsupport()), true);
+		(void)bSelected;
+		return simdkernels;
+	}
+
+#if defined(OFXNDI_X86) && !defined(_MSC_VER)
 
+	// Replacement for the Visual Studio __movsd intrinsic.
+	// n is the number of 4 byte DWORDs.
 	static inline void *__movsd(void *d, const void *s, size_t n) {
-#if defined(__aarch64__)
-        return memcpy(d, s, n);
-#else
-		asm volatile ("rep movsb"
+		asm volatile ("rep movsl"
 			: "=D" (d),
 			"=S" (s),
 			"=c" (n)
@@ -113,15 +229,192 @@ namespace ofxNDIutils {
 			"2" (n)
 			: "memory");
 		return d;
+	}
+
+#elif defined(OFXNDI_NEON)
+
+	static inline void *__movsd(void *d, const void *s, size_t n) {
+		return memcpy(d, s, n*4);
+	}
+
 #endif
-    }
-#endif
+
+	//
+	// Worker threads
+	//
+	// Frames are divided into horizontal bands of about
+	// THREAD_BAND_BYTES per band, small enough to stay in cache.
+	// Bands are taken in turn by the calling thread and a
+	// persistent pool of worker threads.
+	//
+	// One frame is converted by the pool at a time. If the pool
+	// is busy with a frame from another thread, the caller
+	// converts its own frame single threaded.
+	//
+	static const size_t THREAD_BAND_BYTES = 256*1024;
+
+	struct ofxNDIthreads {
+
+		std::vector<std::thread> workers;
+		std::mutex jobmutex;  // One frame at a time
+		std::mutex waitmutex; // Workers wait for a frame
+		std::condition_variable startcv;
+		std::condition_variable donecv;
+		std::atomic<unsigned int> minpixels{1280*720};
+		unsigned int active = 0; // Workers still converting
+		uint64_t frame = 0;      // Incremented for each frame
+		bool bStop = false;
+
+		// Current frame
+		const std::function<void(unsigned int, unsigned int)>* job = nullptr;
+		unsigned int height = 0;
+		unsigned int bandrows = 0;
+		std::atomic<unsigned int> nextband{0};
+
+		~ofxNDIthreads() {
+			Stop();
+		}
+
+		void Stop() {
+			{
+				std::lock_guard<std::mutex> lock(waitmutex);
+				bStop = true;
+			}
+			startcv.notify_all();
+			for (auto &t : workers) {
+				if (t.joinable())
+					t.join();
+			}
+			workers.clear();
+			bStop = false;
+		}
+
+		// Called with jobmutex locked so that frame does not change.
+		// New workers wait for the next frame, not one already converted.
+		void Start(unsigned int nWorkers) {
+			for (unsigned int i = 0; i < nWorkers; i++)
+				workers.emplace_back(&ofxNDIthreads::Worker, this, frame);
+		}
+
+		// Convert bands until there are none left
+		void Bands() {
+			unsigned int band = 0;
+			while ((band = nextband.fetch_add(1)) * bandrows < height) {
+				unsigned int y0 = band * bandrows;
+				unsigned int y1 = std::min(y0 + bandrows, height);
+				(*job)(y0, y1);
+			}
+		}
+
+		void Worker(uint64_t done) {
+			for (;;) {
+				{
+					std::unique_lock<std::mutex> lock(waitmutex);
+					startcv.wait(lock, [&] { return bStop || frame != done; });
+					if (bStop)
+						return;
+					done = frame;
+				}
+				Bands();
+				{
+					std::lock_guard<std::mutex> lock(waitmutex);
+					if (--active == 0)
+						donecv.notify_one();
+				}
+			}
+		}
+	};
+	static ofxNDIthreads threads;
+
+	// Call fn(y0, y1) for bands of lines covering 0 to height.
+	// linebytes is the larger of the source and destination line size.
+	static void ParallelRows(unsigned int width, unsigned int height, size_t linebytes,
+		const std::function<void(unsigned int, unsigned int)> &fn)
+	{
+		if (height == 0)
+			return;
+
+		if (height < 2 || (uint64_t)width * (uint64_t)height < threads.minpixels
+			|| !threads.jobmutex.try_lock()) {
+			fn(0, height);
+			return;
+		}
+
+		if (threads.workers.empty()) {
+			threads.jobmutex.unlock();
+			fn(0, height);
+			return;
+		}
+
+		// Cache sized bands, at least two per thread
+		const unsigned int nThreads = (unsigned int)threads.workers.size() + 1;
+		unsigned int rows = (unsigned int)std::max<size_t>(1, THREAD_BAND_BYTES / std::max<size_t>(1, linebytes));
+		rows = std::min(rows, std::max(1u, height / (nThreads * 2)));
+
+		{
+			std::lock_guard<std::mutex> lock(threads.waitmutex);
+			threads.job = &fn;
+			threads.height = height;
+			threads.bandrows = rows;
+			threads.nextband = 0;
+			threads.active = (unsigned int)threads.workers.size();
+			threads.frame++;
+		}
+		threads.startcv.notify_all();
+
+		// The caller converts bands as well
+		threads.Bands();
+
+		{
+			std::unique_lock<std::mutex> lock(threads.waitmutex);
+			threads.donecv.wait(lock, [] { return threads.active == 0; });
+			threads.job = nullptr;
+		}
+		threads.jobmutex.unlock();
+	}
+
+	// Number of threads used for pixel conversion including the caller
+	// 0 - number of processor cores
+	// 1 - single threaded (default)
+	void SetThreadCount(unsigned int nThreads)
+	{
+		if (nThreads == 0)
+			nThreads = std::max(1u, std::thread::hardware_concurrency());
+		// Wait for any frame in progress
+		std::lock_guard<std::mutex> lock(threads.jobmutex);
+		if (nThreads == (unsigned int)threads.workers.size() + 1)
+			return;
+		threads.Stop();
+		threads.Start(nThreads - 1);
+	}
+
+	unsigned int GetThreadCount()
+	{
+		return (unsigned int)threads.workers.size() + 1;
+	}
+
+	// Frames with fewer pixels are converted single threaded
+	void SetThreadMinimum(unsigned int pixels)
+	{
+		threads.minpixels = pixels;
+	}
+
+	unsigned int GetThreadMinimum()
+	{
+		return threads.minpixels;
+	}
 
 	//
 	// Image pixel copy
 	//
 
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
+	// Plain memcpy for the scalar function table
+	static void memcpy_scalar(void* dst, const void* src, size_t Size)
+	{
+		memcpy(dst, src, Size);
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
 
 	// movsd requires 4 byte aligned data
 	void memcpy_movsd(void* dst, const void* src, size_t Size)
@@ -144,14 +437,28 @@ namespace ofxNDIutils {
 	//
 	// Approx 1.7 times speed of memcpy (0.84 msec per frame 1920x1080)
 	//
+	// Any alignment and size. The destination is aligned
+	// for streaming stores and the remainder copied by memcpy.
+	//
 	void memcpy_sse2(void* dst, const void* src, size_t Size)
 	{
 		char * pSrc = (char *)src;				  // Source buffer
 		char * pDst = (char *)dst;				  // Destination buffer
-		unsigned int n = (unsigned int)Size >> 7; // Counter = size divided by 128 (8 * 128bit registers)
+
+		// Align the destination to 16 bytes
+		size_t head = (16 - ((uintptr_t)pDst & 15)) & 15;
+		if (head > Size) head = Size;
+		if (head > 0) {
+			memcpy(pDst, pSrc, head);
+			pSrc += head;
+			pDst += head;
+			Size -= head;
+		}
+
+		size_t n = Size >> 7; // Counter = size divided by 128 (8 * 128bit registers)
 
 		__m128i Reg0, Reg1, Reg2, Reg3, Reg4, Reg5, Reg6, Reg7;
-		for (unsigned int Index = n; Index > 0; --Index) {
+		for (size_t Index = n; Index > 0; --Index) {
 
 			// SSE2 prefetch
 			_mm_prefetch(pSrc + 256, _MM_HINT_NTA);
@@ -161,14 +468,14 @@ namespace ofxNDIutils {
 			// 8 x 128 bit (16 bytes each)
 			// Increment source pointer by 16 bytes each
 			// for a total of 128 bytes per cycle
-			Reg0 = _mm_load_si128((__m128i *)(pSrc));
-			Reg1 = _mm_load_si128((__m128i *)(pSrc + 16));
-			Reg2 = _mm_load_si128((__m128i *)(pSrc + 32));
-			Reg3 = _mm_load_si128((__m128i *)(pSrc + 48));
-			Reg4 = _mm_load_si128((__m128i *)(pSrc + 64));
-			Reg5 = _mm_load_si128((__m128i *)(pSrc + 80));
-			Reg6 = _mm_load_si128((__m128i *)(pSrc + 96));
-			Reg7 = _mm_load_si128((__m128i *)(pSrc + 112));
+			Reg0 = _mm_loadu_si128((__m128i *)(pSrc));
+			Reg1 = _mm_loadu_si128((__m128i *)(pSrc + 16));
+			Reg2 = _mm_loadu_si128((__m128i *)(pSrc + 32));
+			Reg3 = _mm_loadu_si128((__m128i *)(pSrc + 48));
+			Reg4 = _mm_loadu_si128((__m128i *)(pSrc + 64));
+			Reg5 = _mm_loadu_si128((__m128i *)(pSrc + 80));
+			Reg6 = _mm_loadu_si128((__m128i *)(pSrc + 96));
+			Reg7 = _mm_loadu_si128((__m128i *)(pSrc + 112));
 
 			// move data from registers to dest
 			_mm_stream_si128((__m128i *)(pDst), Reg0);
@@ -183,6 +490,14 @@ namespace ofxNDIutils {
 			pSrc += 128;
 			pDst += 128;
 		}
+
+		// Streaming stores must complete before the buffer is used elsewhere
+		_mm_sfence();
+
+		// Remaining bytes
+		if (Size & 127)
+			memcpy(pDst, pSrc, Size & 127);
+
 	} // end memcpy_sse2
 
 
@@ -197,449 +512,3653 @@ namespace ofxNDIutils {
 	//
 	// All instructions SSE2.
 	//
-	void rgba_bgra_sse2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert)
+	static void rgba_bgra_row_sse2(const uint32_t* src, uint32_t* dst, unsigned int width)
 	{
-		unsigned int y = 0;
 		__m128i brMask = _mm_set1_epi32(0x00ff00ff); // argb
 
-		for (y = 0; y < height; y++) {
+		// Make output writes aligned
+		unsigned int x;
+		for (x = 0; ((reinterpret_cast<intptr_t>(&dst[x]) & 15) != 0) && x < width; x++) {
+			auto rgbapix = src[x];
+			// rgbapix << 16		: a r g b > g b a r
+			//        & 0x00ff00ff  : r g b . > . b . r
+			// rgbapix & 0xff00ff00 : a r g b > a . g .
+			// result of or			:           a b g r
+#if defined(TARGET_WIN32)
+// _rotl is available
+			dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+#else
+// _rotl replacement
+			dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+#endif
+		}
+
+		for (; x + 3 < width; x += 4) {
+			__m128i sourceData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[x]));
+			// Mask out g and a, which don't change
+			__m128i gaComponents = _mm_andnot_si128(brMask, sourceData);
+			// Mask out b and r
+			__m128i brComponents = _mm_and_si128(sourceData, brMask);
+			// Swap b and r
+			__m128i brSwapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(brComponents, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			__m128i result = _mm_or_si128(gaComponents, brSwapped);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&dst[x]), result);
+		}
+
+		// Perform leftover writes
+		for (; x < width; x++) {
+			auto rgbapix = src[x];
+#if defined(TARGET_WIN32)
+			// _rotl is available
+			dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+#else
+			// _rotl replacement
+			dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+#endif
+		}
+	}
+
+	void rgba_bgra_sse2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert,
+		unsigned int sourcePitch, unsigned int destPitch)
+	{
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
 
-			// Start of buffer
-			auto src = static_cast<const uint32_t*>(source); // unsigned int = 4 bytes
-			auto dst = static_cast<uint32_t*>(dest);
+		for (unsigned int y = 0; y < height; y++) {
 
-			// Cast first to avoid warning C26451: Arithmetic overflow
-			unsigned long H1YxW = (unsigned long)((height - 1 - y) * width);
-			unsigned long YxW = (unsigned long)(y * width);
+			// Start of lines
+			auto src = static_cast<const unsigned char*>(source);
+			auto dst = static_cast<unsigned char*>(dest);
 
 			// Increment to current line
 			if (bInvert)
-				src += H1YxW;
+				src += (size_t)(height - 1 - y) * sourcePitch;
+			else
+				src += (size_t)y * sourcePitch;
+
+			dst += (size_t)y * destPitch; // dest is not inverted
+
+			rgba_bgra_row_sse2(reinterpret_cast<const uint32_t*>(src), reinterpret_cast<uint32_t*>(dst), width);
+		}
+	} // end rgba_bgra_sse2
+
+#endif // endif OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	//
+	// AVX2 versions
+	//
+
+	// Fast memcpy with 256 bit registers
+	// 128 bytes per loop
+	OFXNDI_TARGET_AVX2
+	void memcpy_avx2(void* dst, const void* src, size_t Size)
+	{
+		char * pSrc = (char *)src;
+		char * pDst = (char *)dst;
+
+		// Align the destination to 32 bytes
+		size_t head = (32 - ((uintptr_t)pDst & 31)) & 31;
+		if (head > Size) head = Size;
+		if (head > 0) {
+			memcpy(pDst, pSrc, head);
+			pSrc += head;
+			pDst += head;
+			Size -= head;
+		}
+
+		for (size_t Index = Size >> 7; Index > 0; --Index) {
+			_mm_prefetch(pSrc + 256, _MM_HINT_NTA);
+			_mm_prefetch(pSrc + 256 + 64, _MM_HINT_NTA);
+			__m256i Reg0 = _mm256_loadu_si256((const __m256i *)(pSrc));
+			__m256i Reg1 = _mm256_loadu_si256((const __m256i *)(pSrc + 32));
+			__m256i Reg2 = _mm256_loadu_si256((const __m256i *)(pSrc + 64));
+			__m256i Reg3 = _mm256_loadu_si256((const __m256i *)(pSrc + 96));
+			_mm256_stream_si256((__m256i *)(pDst), Reg0);
+			_mm256_stream_si256((__m256i *)(pDst + 32), Reg1);
+			_mm256_stream_si256((__m256i *)(pDst + 64), Reg2);
+			_mm256_stream_si256((__m256i *)(pDst + 96), Reg3);
+			pSrc += 128;
+			pDst += 128;
+		}
+
+		_mm_sfence();
+
+		if (Size & 127)
+			memcpy(pDst, pSrc, Size & 127);
+
+	} // end memcpy_avx2
+
+	// Swap red and blue with a byte shuffle
+	// 16 pixels per loop
+	OFXNDI_TARGET_AVX2
+	static void rgba_bgra_row_avx2(const uint32_t* src, uint32_t* dst, unsigned int width)
+	{
+		const __m256i swap = _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[x]));
+			__m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[x + 8]));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[x]), _mm256_shuffle_epi8(p0, swap));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[x + 8]), _mm256_shuffle_epi8(p1, swap));
+		}
+
+		// Remaining pixels
+		if (x < width)
+			rgba_bgra_row_sse2(src + x, dst + x, width - x);
+	}
+
+	OFXNDI_TARGET_AVX2
+	void rgba_bgra_avx2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert,
+		unsigned int sourcePitch, unsigned int destPitch)
+	{
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
+
+		for (unsigned int y = 0; y < height; y++) {
+			auto src = static_cast<const unsigned char*>(source);
+			auto dst = static_cast<unsigned char*>(dest);
+			if (bInvert)
+				src += (size_t)(height - 1 - y) * sourcePitch;
 			else
-				src += YxW;
-
-			dst += YxW; // dest is not inverted
-
-			// Make output writes aligned
-			unsigned int x;
-			for (x = 0; ((reinterpret_cast<intptr_t>(&dst[x]) & 15) != 0) && x < width; x++) {
-				auto rgbapix = src[x];
-				// rgbapix << 16		: a r g b > g b a r
-				//        & 0x00ff00ff  : r g b . > . b . r
-				// rgbapix & 0xff00ff00 : a r g b > a . g .
-				// result of or			:           a b g r
+				src += (size_t)y * sourcePitch;
+			dst += (size_t)y * destPitch; // dest is not inverted
+			rgba_bgra_row_avx2(reinterpret_cast<const uint32_t*>(src), reinterpret_cast<uint32_t*>(dst), width);
+		}
+	} // end rgba_bgra_avx2
+
+#endif // endif OFXNDI_X86
+
+	// Scalar line conversion
+	static void rgba_bgra_row(const uint32_t* source, uint32_t* dest, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++) {
+			auto rgbapix = source[x];
 #if defined(TARGET_WIN32)
-// _rotl is available
-				dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+			// _rotl is available
+			dest[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
 #else
-// _rotl replacement
-				dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+			// _rotl replacement
+			dest[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
+#endif
+		}
+	}
+
+	// rgba <> bgra using the SIMD level selected
+	void rgba_bgra(const void *rgba_source, void *bgra_dest,
+		unsigned int width, unsigned int height, bool bInvert,
+		unsigned int sourcePitch, unsigned int destPitch)
+	{
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+
+			for (unsigned int y = y0; y < y1; y++) {
+
+				// Start of lines
+				auto source = static_cast<const unsigned char*>(rgba_source);
+				auto dest = static_cast<unsigned char*>(bgra_dest);
+
+				// Increment to current line
+				if (bInvert)
+					source += (size_t)(height - 1 - y) * sourcePitch;
+				else
+					source += (size_t)y * sourcePitch;
+				dest += (size_t)y * destPitch; // dest is not inverted
+
+				Kernels().rgba_bgra(reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(dest), width);
+
+			}
+
+		});
+
+	} // end rgba_bgra
+
+
+	// Flip rgba source to dest
+	// Only width*4 bytes of each line are copied.
+	void FlipBuffer(const unsigned char *src,
+		unsigned char *dst,
+		unsigned int width,
+		unsigned int height,
+		unsigned int sourcePitch,
+		unsigned int destPitch)
+	{
+		const unsigned char * From = src;
+		unsigned char * To = dst;
+		const size_t linebytes = (size_t)width * 4; // RGBA
+		if (sourcePitch == 0) sourcePitch = width * 4;
+		if (destPitch == 0) destPitch = width * 4;
+
+		// Small images just use memcpy
+		void (*copy)(void*, const void*, size_t) = Kernels().copy;
+		if (width <= 512 || height <= 512)
+			copy = memcpy_scalar;
+
+		ParallelRows(width, height, linebytes, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				copy((void *)(To + (size_t)(height - 1 - y)*destPitch),
+					(const void *)(From + (size_t)y*sourcePitch), linebytes);
+			}
+		});
+	} // end FlipBuffer
+
+	//
+	// Flip an image vertically in place
+	//
+
+	// Exchange two lines through a small stack buffer.
+	// The chunk stays in the cache so memcpy is not limited by memory bandwidth.
+	static void swap_rows(unsigned char* a, unsigned char* b, size_t bytes)
+	{
+		unsigned char chunk[1024];
+		while (bytes > 0) {
+			const size_t n = bytes < sizeof(chunk) ? bytes : sizeof(chunk);
+			memcpy(chunk, a, n);
+			memcpy(a, b, n);
+			memcpy(b, chunk, n);
+			a += n;
+			b += n;
+			bytes -= n;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// SSE2 - exchange 64 bytes per loop through registers
+	static void swap_rows_sse2(unsigned char* a, unsigned char* b, size_t bytes)
+	{
+		size_t i = 0;
+		for (; i + 64 <= bytes; i += 64) {
+			__m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			__m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16));
+			__m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32));
+			__m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48));
+			__m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			__m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16));
+			__m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32));
+			__m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a + i),      b0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a + i + 16), b1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a + i + 32), b2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a + i + 48), b3);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i),      a0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i + 16), a1);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i + 32), a2);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i + 48), a3);
+		}
+		if (i < bytes)
+			swap_rows(a + i, b + i, bytes - i);
+	}
+
 #endif
+
+	// Flip rgba pixels vertically in the same buffer
+	// by exchanging lines from the top and bottom.
+	// Only width*4 bytes of each line are moved.
+	// No allocation. Lines are swapped through SIMD registers
+	// or a small stack buffer for the scalar level.
+	bool FlipVertical(unsigned char *buffer, unsigned int width, unsigned int height, unsigned int pitch)
+	{
+		if (!buffer)
+			return false;
+
+		// Nothing to exchange
+		if (width == 0 || height < 2)
+			return true;
+
+		const size_t linebytes = (size_t)width * 4; // RGBA
+		if (pitch == 0) pitch = width * 4;
+
+		// Each band exchanges lines y0 to y1 with the mirrored lines
+		ParallelRows(width*2, height/2, linebytes*2, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				Kernels().swap_rows(buffer + (size_t)y*pitch,
+					buffer + (size_t)(height - 1 - y)*pitch, linebytes);
+			}
+		});
+
+		return true;
+	}
+
+	// ofxNDI version number string
+	// Major, minor, release
+	std::string GetVersion()
+	{
+		return ofxNDIversion;
+	}
+
+	// Copy rgba source image to dest.
+	// Images must be the same size with no line padding.
+	// Option flip image vertically (invert).
+	void CopyImage(const unsigned char *source, unsigned char *dest,
+		unsigned int width, unsigned int height, bool bInvert)
+	{
+		CopyImage(source, dest,	width, height, width*4, false, bInvert);
+
+	} // end CopyImage
+
+	// Copy rgba source image to dest.
+	// Source line pitch (stride). Destination pitch is width*4.
+	// Option convert bgra<>rgba.
+	// Option flip image vertically (invert).
+	void CopyImage(const unsigned char *source, unsigned char *dest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		bool bSwapRB, bool bInvert)
+	{
+		CopyImage((const void *)source, (void *)dest, width, height, stride, width*4, bInvert, bSwapRB);
+	} // end CopyImage
+
+
+	// Copy rgba image buffers line by line.
+	// Allow for both source and destination line pitch.
+	// Option flip image vertically (invert).
+	// Option convert bgra<>rgba in the same pass.
+	void CopyImage(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch,
+		bool bInvert, bool bSwapRB)
+	{
+		if (rgba_source == nullptr || rgba_dest == nullptr)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
+
+		if (bSwapRB) {
+			rgba_bgra(rgba_source, rgba_dest, width, height, bInvert, sourcePitch, destPitch);
+			return;
+		}
+
+		if (bInvert) {
+			FlipBuffer(static_cast<const unsigned char *>(rgba_source), static_cast<unsigned char *>(rgba_dest),
+				width, height, sourcePitch, destPitch);
+			return;
+		}
+
+		auto source = static_cast<const unsigned char *>(rgba_source);
+		auto dest = static_cast<unsigned char *>(rgba_dest);
+
+		// Lines without padding are copied as one block
+		if (sourcePitch == width*4 && destPitch == width*4) {
+			// Small image just use memcpy
+			if (width < 512 || height < 256) {
+				memcpy((void *)dest, (const void *)source, (size_t)height * (size_t)sourcePitch);
+			}
+			else {
+				// SSE2 or AVX2 if available
+				// Contiguous bands of lines for multiple threads
+				ParallelRows(width, height, sourcePitch, [&](unsigned int y0, unsigned int y1) {
+					const size_t offset = (size_t)y0 * (size_t)sourcePitch;
+					Kernels().copy((void *)(dest + offset), (const void *)(source + offset), (size_t)(y1 - y0) * (size_t)sourcePitch);
+				});
+			}
+			return;
+		}
+
+		// Padded lines are copied individually
+		// Padding of the destination is not changed
+		void (*copy)(void*, const void*, size_t) = Kernels().copy;
+		if (width < 512)
+			copy = memcpy_scalar;
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				copy((void *)(dest + (size_t)y * destPitch),
+					(const void *)(source + (size_t)y * sourcePitch), (size_t)width * 4);
+			}
+		});
+	}
+
+	//
+	//        RGB to RGBA
+	//
+
+	// Scalar reference
+	static void rgb_rgba_row(const unsigned char* rgb, unsigned char* rgba, unsigned int width, bool bSwapRB)
+	{
+		const int r = bSwapRB ? 2 : 0;
+		const int b = bSwapRB ? 0 : 2;
+		for (unsigned int x = 0; x < width; x++) {
+			rgba[0] = rgb[r];
+			rgba[1] = rgb[1];
+			rgba[2] = rgb[b];
+			rgba[3] = 255;
+			rgb  += 3;
+			rgba += 4;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// SSSE3 byte shuffle (NEON tbl with sse2neon)
+	// 16 pixels per loop from three 16 byte loads
+	// Also used for AVX2. A 256 bit version is no faster
+	// because the conversion is limited by memory bandwidth.
+	OFXNDI_TARGET_SSSE3
+	static void rgb_rgba_row_ssse3(const unsigned char* rgb, unsigned char* rgba, unsigned int width, bool bSwapRB)
+	{
+		// Source byte for each destination byte. Alpha is cleared and set by the mask.
+		const __m128i shuffle = bSwapRB
+			? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+			: _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+		const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb));
+			__m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 16));
+			__m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 32));
+			// Four pixels (12 bytes) at the start of each register
+			__m128i p1 = _mm_alignr_epi8(s1, s0, 12);
+			__m128i p2 = _mm_alignr_epi8(s2, s1, 8);
+			__m128i p3 = _mm_srli_si128(s2, 4);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba),      _mm_or_si128(_mm_shuffle_epi8(s0, shuffle), alpha));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 16), _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), alpha));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 32), _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), alpha));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 48), _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), alpha));
+			rgb  += 48;
+			rgba += 64;
+		}
+		if (x < width)
+			rgb_rgba_row(rgb, rgba, width - x, bSwapRB);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+	// Copy rgb source to rgba dest
+	// Option bgr source (bSwapRB)
+	void rgb2rgba(const void* rgb_source, void* rgba_dest, unsigned int width, unsigned int height, bool bInvert,
+		unsigned int sourcePitch, unsigned int destPitch, bool bSwapRB)
+	{
+		if (!rgb_source || !rgba_dest)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*3;
+		if (destPitch == 0) destPitch = width*4;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				// Start of lines
+				auto rgb = static_cast<const unsigned char*>(rgb_source); // rgb/bgr
+				auto rgba = static_cast<unsigned char*>(rgba_dest); // rgba/bgra
+				rgb  += (uint64_t)(bInvert ? (height - 1 - y) : y) * sourcePitch;
+				rgba += (uint64_t)y * destPitch;
+				Kernels().rgb_rgba(rgb, rgba, width, bSwapRB);
+			}
+		});
+
+	} // end rgb2rgba
+
+	//
+	//        Premultiply and unpremultiply alpha
+	//
+	// Key/fill workflows use premultiplied colour on one side
+	// and straight alpha on the other. The conversion is in the
+	// same pass as rgba<>bgra swap, flip and line pitch.
+	//
+	// Premultiply   c = round(c*a/255)
+	// Unpremultiply c = min(255, (c*255 + a/2)/a), 0 for a = 0
+	//
+	// The SIMD unpremultiply multiplies by a float reciprocal of alpha.
+	// The quotient is within one and is corrected from the remainder,
+	// so all levels match the scalar integer division exactly.
+	//
+
+	// Exact round(x/255) for x = c*a
+	static inline unsigned int div255(unsigned int x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	// Scalar reference
+	static void premultiply_row(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const int r = bSwapRB ? 2 : 0;
+		const int b = bSwapRB ? 0 : 2;
+		for (unsigned int x = 0; x < width; x++) {
+			const unsigned int a = src[3];
+			const unsigned char cr = (unsigned char)div255(src[r] * a);
+			const unsigned char cg = (unsigned char)div255(src[1] * a);
+			const unsigned char cb = (unsigned char)div255(src[b] * a);
+			dst[0] = cr;
+			dst[1] = cg;
+			dst[2] = cb;
+			dst[3] = (unsigned char)a;
+			src += 4;
+			dst += 4;
+		}
+	}
+
+	static inline unsigned char unpremultiply(unsigned int c, unsigned int a)
+	{
+		return (unsigned char)std::min(255u, (c*255 + a/2)/a);
+	}
+
+	static void unpremultiply_row(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const int r = bSwapRB ? 2 : 0;
+		const int b = bSwapRB ? 0 : 2;
+		for (unsigned int x = 0; x < width; x++) {
+			const unsigned int a = src[3];
+			unsigned char cr = 0, cg = 0, cb = 0;
+			if (a > 0) {
+				cr = unpremultiply(src[r], a);
+				cg = unpremultiply(src[1], a);
+				cb = unpremultiply(src[b], a);
+			}
+			dst[0] = cr;
+			dst[1] = cg;
+			dst[2] = cb;
+			dst[3] = (unsigned char)a;
+			src += 4;
+			dst += 4;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// Multiply 16 bit r,g,b,a of two pixels by a,a,a,255 and divide by 255
+	static inline __m128i premultiply_sse2(__m128i p, __m128i alphalane, bool bSwapRB)
+	{
+		__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		a = _mm_or_si128(a, alphalane); // 255 for alpha
+		if (bSwapRB)
+			p = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 0, 1, 2)), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i x = _mm_add_epi16(_mm_mullo_epi16(p, a), _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+	}
+
+	// SSE2 - 4 pixels per loop
+	static void premultiply_row_sse2(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alphalane = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+		unsigned int x = 0;
+		for (; x + 4 <= width; x += 4) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			__m128i lo = premultiply_sse2(_mm_unpacklo_epi8(v, zero), alphalane, bSwapRB);
+			__m128i hi = premultiply_sse2(_mm_unpackhi_epi8(v, zero), alphalane, bSwapRB);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+			src += 16;
+			dst += 16;
+		}
+		if (x < width)
+			premultiply_row(src, dst, width - x, bSwapRB);
+	}
+
+	// One channel of 4 pixels (32 bit) divided by alpha and scaled by 255
+	// inv is 1/a. The float quotient is within one of the integer
+	// quotient and is corrected from the remainder.
+	static inline __m128i unpremultiply_sse2(__m128i c, __m128 fa, __m128 inv, __m128 half)
+	{
+		// c*255 + a/2 is exact in float
+		const __m128 n = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), _mm_set1_ps(255.0f)), half);
+		__m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(n, inv)));
+		const __m128 r = _mm_sub_ps(n, _mm_mul_ps(q, fa));
+		q = _mm_add_ps(q, _mm_and_ps(_mm_cmpge_ps(r, fa), _mm_set1_ps(1.0f)));
+		q = _mm_sub_ps(q, _mm_and_ps(_mm_cmplt_ps(r, _mm_setzero_ps()), _mm_set1_ps(1.0f)));
+		// Clamp to 255
+		return _mm_cvttps_epi32(_mm_min_ps(q, _mm_set1_ps(255.0f)));
+	}
+
+	// SSE2 - 4 pixels per loop
+	// Each 32 bit lane is one pixel, so the channels are separated by shift and mask.
+	static void unpremultiply_row_sse2(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const __m128i mask = _mm_set1_epi32(0xff);
+		const __m128 one = _mm_set1_ps(1.0f);
+		unsigned int x = 0;
+		for (; x + 4 <= width; x += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+			const __m128i a = _mm_srli_epi32(v, 24);
+			const __m128 fa = _mm_cvtepi32_ps(a);
+			const __m128 inv = _mm_div_ps(one, _mm_max_ps(fa, one));
+			const __m128 half = _mm_cvtepi32_ps(_mm_srli_epi32(a, 1));
+			__m128i r = unpremultiply_sse2(_mm_and_si128(v, mask), fa, inv, half);
+			__m128i g = unpremultiply_sse2(_mm_and_si128(_mm_srli_epi32(v, 8), mask), fa, inv, half);
+			__m128i b = unpremultiply_sse2(_mm_and_si128(_mm_srli_epi32(v, 16), mask), fa, inv, half);
+			if (bSwapRB)
+				std::swap(r, b);
+			__m128i p = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_slli_epi32(b, 16));
+			// Zero for zero alpha
+			p = _mm_andnot_si128(_mm_cmpeq_epi32(a, _mm_setzero_si128()), p);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_or_si128(p, _mm_slli_epi32(a, 24)));
+			src += 16;
+			dst += 16;
+		}
+		if (x < width)
+			unpremultiply_row(src, dst, width - x, bSwapRB);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	// AVX2 - 8 pixels per loop
+	OFXNDI_TARGET_AVX2
+	static void premultiply_row_avx2(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i alphalane = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+		const __m256i round = _mm256_set1_epi16(128);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			if (bSwapRB)
+				v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+					2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+			__m256i lo = _mm256_unpacklo_epi8(v, zero);
+			__m256i hi = _mm256_unpackhi_epi8(v, zero);
+			__m256i alo = _mm256_or_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, 0xFF), 0xFF), alphalane);
+			__m256i ahi = _mm256_or_si256(_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, 0xFF), 0xFF), alphalane);
+			lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, alo), round);
+			hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, ahi), round);
+			lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+			hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+			// Unpack and pack are within each 128 bit lane so the pixel order is kept
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_packus_epi16(lo, hi));
+			src += 32;
+			dst += 32;
+		}
+		if (x < width)
+			premultiply_row_sse2(src, dst, width - x, bSwapRB);
+	}
+
+	// One channel of 8 pixels (32 bit) divided by alpha and scaled by 255
+	OFXNDI_TARGET_AVX2
+	static inline __m256i unpremultiply_avx2(__m256i c, __m256i a, __m256 inv, __m256i half)
+	{
+		// c*255 + a/2
+		const __m256i n = _mm256_add_epi32(_mm256_sub_epi32(_mm256_slli_epi32(c, 8), c), half);
+		__m256i q = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(n), inv));
+		const __m256i r = _mm256_sub_epi32(n, _mm256_mullo_epi32(q, a));
+		q = _mm256_sub_epi32(q, _mm256_cmpgt_epi32(r, _mm256_sub_epi32(a, _mm256_set1_epi32(1))));
+		q = _mm256_add_epi32(q, _mm256_cmpgt_epi32(_mm256_setzero_si256(), r));
+		return _mm256_min_epi32(q, _mm256_set1_epi32(255));
+	}
+
+	// AVX2 - 8 pixels per loop
+	OFXNDI_TARGET_AVX2
+	static void unpremultiply_row_avx2(const unsigned char* src, unsigned char* dst, unsigned int width, bool bSwapRB)
+	{
+		const __m256i mask = _mm256_set1_epi32(0xff);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+			const __m256i a = _mm256_srli_epi32(v, 24);
+			const __m256 inv = _mm256_div_ps(one, _mm256_max_ps(_mm256_cvtepi32_ps(a), one));
+			const __m256i half = _mm256_srli_epi32(a, 1);
+			__m256i r = unpremultiply_avx2(_mm256_and_si256(v, mask), a, inv, half);
+			__m256i g = unpremultiply_avx2(_mm256_and_si256(_mm256_srli_epi32(v, 8), mask), a, inv, half);
+			__m256i b = unpremultiply_avx2(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask), a, inv, half);
+			if (bSwapRB)
+				std::swap(r, b);
+			__m256i p = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)), _mm256_slli_epi32(b, 16));
+			p = _mm256_andnot_si256(_mm256_cmpeq_epi32(a, _mm256_setzero_si256()), p);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_or_si256(p, _mm256_slli_epi32(a, 24)));
+			src += 32;
+			dst += 32;
+		}
+		if (x < width)
+			unpremultiply_row_sse2(src, dst, width - x, bSwapRB);
+	}
+
+#endif // OFXNDI_X86
+
+	// Premultiply or unpremultiply lines of rgba pixels
+	static void AlphaImage(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch, bool bInvert, bool bSwapRB,
+		void (*row)(const unsigned char*, unsigned char*, unsigned int, bool))
+	{
+		if (!rgba_source || !rgba_dest)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				auto src = static_cast<const unsigned char*>(rgba_source) + (size_t)y * sourcePitch;
+				auto dst = static_cast<unsigned char*>(rgba_dest) + (size_t)(bInvert ? height - 1 - y : y) * destPitch;
+				row(src, dst, width, bSwapRB);
+			}
+		});
+	}
+
+	// 1920x1080 : 5.2 msec scalar, 1.5 msec SSE2, 0.9 msec AVX2
+	void PremultiplyAlpha(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch, bool bInvert, bool bSwapRB)
+	{
+		AlphaImage(rgba_source, rgba_dest, width, height, sourcePitch, destPitch, bInvert, bSwapRB, Kernels().premultiply);
+	}
+
+	// 1920x1080 : 15 msec scalar, 6.2 msec SSE2, 2.7 msec AVX2
+	void UnpremultiplyAlpha(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch, bool bInvert, bool bSwapRB)
+	{
+		AlphaImage(rgba_source, rgba_dest, width, height, sourcePitch, destPitch, bInvert, bSwapRB, Kernels().unpremultiply);
+	}
+
+	// Copy with alpha conversion
+	void CopyImage(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch,
+		bool bInvert, bool bSwapRB, ofxNDIalphamode alpha)
+	{
+		if (alpha == alpha_premultiply)
+			PremultiplyAlpha(rgba_source, rgba_dest, width, height, sourcePitch, destPitch, bInvert, bSwapRB);
+		else if (alpha == alpha_unpremultiply)
+			UnpremultiplyAlpha(rgba_source, rgba_dest, width, height, sourcePitch, destPitch, bInvert, bSwapRB);
+		else
+			CopyImage(rgba_source, rgba_dest, width, height, sourcePitch, destPitch, bInvert, bSwapRB);
+	}
+
+	// True if the table has 1D or 3D entries
+	static inline bool LUTused(const ofxNDIlut* lut)
+	{
+		return lut && (lut->b1D || lut->size >= 2);
+	}
+
+	// Lookup table and alpha conversion of a converted line in place
+	// while the line is still in cache.
+	// The table grades straight colour, so a premultiplied source
+	// is unpremultiplied before it and a straight source premultiplied after it.
+	static void GradeRow(const ofxNDIlut* lut, ofxNDIalphamode alpha, unsigned char* rgba, unsigned int width)
+	{
+		if (alpha == alpha_unpremultiply)
+			Kernels().unpremultiply(rgba, rgba, width, false);
+		if (lut)
+			Kernels().lut_rgba(*lut, rgba, rgba, width);
+		if (alpha == alpha_premultiply)
+			Kernels().premultiply(rgba, rgba, width, false);
+	}
+
+	//
+	//        YUV422_to_RGBA
+	//
+
+	//
+	// Integer coefficients for YUV to RGB
+	//
+	// Limited range : Y 16-235, U and V 16-240 > 0-255
+	// R = 255/219(Y - 16) + 255/224 * 2(1-Kr)(V - 128)
+	// G = 255/219(Y - 16) - 255/224 * 2(1-Kb)Kb/Kg(U - 128) - 255/224 * 2(1-Kr)Kr/Kg(V - 128)
+	// B = 255/219(Y - 16) + 255/224 * 2(1-Kb)(U - 128)
+	//
+	// Full range : Y, U and V 0-255 > 0-255
+	// As above without the Y offset and 255/219, 255/224 scaling
+	//
+	// Scaled by 256 for 16 bit SIMD multiply-add. e.g. BT.709 limited
+	// R = (298(Y - 16) + 459(V - 128) + 128) / 256
+	// G = (298(Y - 16) - 55(U - 128) - 136(V - 128) + 128) / 256
+	// B = (298(Y - 16) + 541(U - 128) + 128) / 256
+	//
+	// Calculated at compile time. There is no global state,
+	// so that receivers on different threads can convert concurrently.
+	//
+	struct YUVcoefficients {
+		int y;  // Y to RGB
+		int vr; // V to R
+		int ug; // U to G
+		int vg; // V to G
+		int ub; // U to B
+		int yoffset; // 16 limited, 0 full range
+	};
+
+	static constexpr int YUVcoef(double c)
+	{
+		return (int)(c * 256.0 + (c < 0.0 ? -0.5 : 0.5));
+	}
+
+	static constexpr YUVcoefficients YUVmatrix(double kr, double kb, bool bFull)
+	{
+		return {
+			YUVcoef(bFull ? 1.0 : 255.0/219.0),
+			YUVcoef((bFull ? 1.0 : 255.0/224.0) * 2.0*(1.0-kr)),
+			YUVcoef((bFull ? 1.0 : 255.0/224.0) * -2.0*(1.0-kb)*kb/(1.0-kr-kb)),
+			YUVcoef((bFull ? 1.0 : 255.0/224.0) * -2.0*(1.0-kr)*kr/(1.0-kr-kb)),
+			YUVcoef((bFull ? 1.0 : 255.0/224.0) * 2.0*(1.0-kb)),
+			bFull ? 0 : 16
+		};
+	}
+
+	// [range][matrix] BT.601, BT.709, BT.2020
+	static constexpr YUVcoefficients YUVcoefs[2][3] = {
+		{ YUVmatrix(0.299, 0.114, false), YUVmatrix(0.2126, 0.0722, false), YUVmatrix(0.2627, 0.0593, false) },
+		{ YUVmatrix(0.299, 0.114, true),  YUVmatrix(0.2126, 0.0722, true),  YUVmatrix(0.2627, 0.0593, true) }
+	};
+
+	// SD BT.601 for widths less than 720
+	// HD BT.709 up to 3840, UHD BT.2020 above
+	// (as for the sender and receiver shaders)
+	static ofxNDIcolormatrix AutoMatrix(ofxNDIcolormatrix matrix, unsigned int width)
+	{
+		if (matrix != matrix_auto)
+			return matrix;
+		if (width < 720)
+			return matrix_bt601;
+		if (width < 3840)
+			return matrix_bt709;
+		return matrix_bt2020;
+	}
+
+	static const YUVcoefficients &YUVselect(ofxNDIcolormatrix matrix, ofxNDIcolorrange range, unsigned int width)
+	{
+		return YUVcoefs[range == range_full ? 1 : 0][AutoMatrix(matrix, width)];
+	}
+
+	// Clamp out of range values 0-255
+	inline unsigned char clamp8(int v) {
+		return (unsigned char)((v & ~255) ? (v < 0 ? 0 : 255) : v);
+	}
+
+	//
+	// UYVY to RGBA line conversion
+	//
+	// Y sampled at every pixel
+	// U and V sampled at every second pixel
+	// An odd final pixel uses the U and V of its own macropixel.
+	// Option BGRA output (bSwapRB) at no extra cost.
+	//
+
+	// Scalar reference
+	static void uyvy_rgba_row(const unsigned char* yuv, unsigned char* rgba, unsigned int width, const YUVcoefficients &c, bool bSwapRB)
+	{
+		// Red and blue byte offsets
+		const int ri = bSwapRB ? 2 : 0;
+		const int bi = 2 - ri;
+
+		unsigned int x = 0;
+		for (; x + 1 < width; x += 2) {
+
+			int u  = *yuv++ - 128;
+			int y0 = *yuv++ - c.yoffset;
+			int v  = *yuv++ - 128;
+			int y1 = *yuv++ - c.yoffset;
+
+			//
+			// uyvy to rgb with color space conversion
+			//
+
+			// Chroma shared by both pixels
+			int cr = c.vr*v + 128;
+			int cg = c.ug*u + c.vg*v + 128;
+			int cb = c.ub*u + 128;
+			int y0v = c.y * std::max(y0, 0);
+			int y1v = c.y * std::max(y1, 0);
+
+			// rgba pixel 1
+			int r = (y0v + cr) >> 8;
+			int g = (y0v + cg) >> 8;
+			int b = (y0v + cb) >> 8;
+
+			rgba[ri] = clamp8(r);
+			rgba[1]  = clamp8(g);
+			rgba[bi] = clamp8(b);
+			rgba[3]  = 255;
+
+			// rgba pixel 2
+			r = (y1v + cr) >> 8;
+			g = (y1v + cg) >> 8;
+			b = (y1v + cb) >> 8;
+
+			rgba[ri+4] = clamp8(r);
+			rgba[5]    = clamp8(g);
+			rgba[bi+4] = clamp8(b);
+			rgba[7]    = 255;
+			rgba += 8;
+		}
+
+		if (x < width) {
+			int u  = yuv[0] - 128;
+			int v  = yuv[2] - 128;
+			int y0v = c.y * std::max(yuv[1] - c.yoffset, 0);
+			rgba[ri] = clamp8((y0v + c.vr*v + 128) >> 8);
+			rgba[1]  = clamp8((y0v + c.ug*u + c.vg*v + 128) >> 8);
+			rgba[bi] = clamp8((y0v + c.ub*u + 128) >> 8);
+			rgba[3]  = 255;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// Two 16 bit values in each 32 bit lane for _mm_madd_epi16
+	static inline __m128i pair16(int lo, int hi)
+	{
+		return _mm_set1_epi32((int)(((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo));
+	}
+
+	//
+	// SSE2 - 8 pixels per loop
+	//
+	// Each 32 bit lane holds one macropixel U Y0 V Y1.
+	// U,V and Y0,Y1 are separated into 16 bit pairs so that
+	// _mm_madd_epi16 gives the 32 bit sums of the table method.
+	// Saturated packing to 8 bits is the same as clamp8.
+	// For BGRA, the red and blue coefficients are exchanged.
+	//
+	static void uyvy_rgba_row_sse2(const unsigned char* yuv, unsigned char* rgba, unsigned int width, const YUVcoefficients &c, bool bSwapRB)
+	{
+		const __m128i ysub  = _mm_set1_epi32((c.yoffset << 24) | (c.yoffset << 8)); // Y offset for bytes 1 and 3
+		const __m128i mask  = _mm_set1_epi16(0x00FF);
+		const __m128i c128  = _mm_set1_epi16(128);
+		const __m128i round = _mm_set1_epi32(128);
+		const __m128i alpha = _mm_set1_epi16(255);
+		const __m128i kr  = bSwapRB ? pair16(c.ub, 0) : pair16(0, c.vr);
+		const __m128i kg  = pair16(c.ug, c.vg);
+		const __m128i kb  = bSwapRB ? pair16(0, c.vr) : pair16(c.ub, 0);
+		const __m128i ky0 = pair16(c.y, 0);
+		const __m128i ky1 = pair16(0, c.y);
+
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+
+			__m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuv));
+
+			// U-128, V-128 and Y0-offset, Y1-offset pairs
+			__m128i uv = _mm_sub_epi16(_mm_and_si128(src, mask), c128);
+			__m128i yy = _mm_srli_epi16(_mm_subs_epu8(src, ysub), 8);
+
+			// Chroma shared by both pixels
+			__m128i cr = _mm_add_epi32(_mm_madd_epi16(uv, kr), round);
+			__m128i cg = _mm_add_epi32(_mm_madd_epi16(uv, kg), round);
+			__m128i cb = _mm_add_epi32(_mm_madd_epi16(uv, kb), round);
+			__m128i y0 = _mm_madd_epi16(yy, ky0);
+			__m128i y1 = _mm_madd_epi16(yy, ky1);
+
+			__m128i r0 = _mm_srai_epi32(_mm_add_epi32(y0, cr), 8);
+			__m128i r1 = _mm_srai_epi32(_mm_add_epi32(y1, cr), 8);
+			__m128i g0 = _mm_srai_epi32(_mm_add_epi32(y0, cg), 8);
+			__m128i g1 = _mm_srai_epi32(_mm_add_epi32(y1, cg), 8);
+			__m128i b0 = _mm_srai_epi32(_mm_add_epi32(y0, cb), 8);
+			__m128i b1 = _mm_srai_epi32(_mm_add_epi32(y1, cb), 8);
+
+			// Pixel order 16 bit
+			__m128i r = _mm_packs_epi32(_mm_unpacklo_epi32(r0, r1), _mm_unpackhi_epi32(r0, r1));
+			__m128i g = _mm_packs_epi32(_mm_unpacklo_epi32(g0, g1), _mm_unpackhi_epi32(g0, g1));
+			__m128i b = _mm_packs_epi32(_mm_unpacklo_epi32(b0, b1), _mm_unpackhi_epi32(b0, b1));
+
+			// Clamp to 8 bits and interleave
+			__m128i rb = _mm_packus_epi16(r, b);     // r0..r7 b0..b7
+			__m128i ga = _mm_packus_epi16(g, alpha); // g0..g7 a0..a7
+			__m128i rg = _mm_unpacklo_epi8(rb, ga);  // r g r g
+			__m128i ba = _mm_unpackhi_epi8(rb, ga);  // b a b a
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba), _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 16), _mm_unpackhi_epi16(rg, ba));
+
+			yuv  += 16;
+			rgba += 32;
+		}
+
+		// Remaining pixels
+		if (x < width)
+			uyvy_rgba_row(yuv, rgba, width - x, c, bSwapRB);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	//
+	// AVX2 - 16 pixels per loop
+	//
+	// As for SSE2, with each 128 bit lane converted independently.
+	// The lanes are re-ordered for the store.
+	//
+	OFXNDI_TARGET_AVX2
+	static void uyvy_rgba_row_avx2(const unsigned char* yuv, unsigned char* rgba, unsigned int width, const YUVcoefficients &c, bool bSwapRB)
+	{
+		const __m256i ysub  = _mm256_set1_epi32((c.yoffset << 24) | (c.yoffset << 8));
+		const __m256i mask  = _mm256_set1_epi16(0x00FF);
+		const __m256i c128  = _mm256_set1_epi16(128);
+		const __m256i round = _mm256_set1_epi32(128);
+		const __m256i alpha = _mm256_set1_epi16(255);
+		const __m256i kr  = _mm256_broadcastsi128_si256(bSwapRB ? pair16(c.ub, 0) : pair16(0, c.vr));
+		const __m256i kg  = _mm256_broadcastsi128_si256(pair16(c.ug, c.vg));
+		const __m256i kb  = _mm256_broadcastsi128_si256(bSwapRB ? pair16(0, c.vr) : pair16(c.ub, 0));
+		const __m256i ky0 = _mm256_broadcastsi128_si256(pair16(c.y, 0));
+		const __m256i ky1 = _mm256_broadcastsi128_si256(pair16(0, c.y));
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+
+			__m256i src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuv));
+
+			__m256i uv = _mm256_sub_epi16(_mm256_and_si256(src, mask), c128);
+			__m256i yy = _mm256_srli_epi16(_mm256_subs_epu8(src, ysub), 8);
+
+			__m256i cr = _mm256_add_epi32(_mm256_madd_epi16(uv, kr), round);
+			__m256i cg = _mm256_add_epi32(_mm256_madd_epi16(uv, kg), round);
+			__m256i cb = _mm256_add_epi32(_mm256_madd_epi16(uv, kb), round);
+			__m256i y0 = _mm256_madd_epi16(yy, ky0);
+			__m256i y1 = _mm256_madd_epi16(yy, ky1);
+
+			__m256i r0 = _mm256_srai_epi32(_mm256_add_epi32(y0, cr), 8);
+			__m256i r1 = _mm256_srai_epi32(_mm256_add_epi32(y1, cr), 8);
+			__m256i g0 = _mm256_srai_epi32(_mm256_add_epi32(y0, cg), 8);
+			__m256i g1 = _mm256_srai_epi32(_mm256_add_epi32(y1, cg), 8);
+			__m256i b0 = _mm256_srai_epi32(_mm256_add_epi32(y0, cb), 8);
+			__m256i b1 = _mm256_srai_epi32(_mm256_add_epi32(y1, cb), 8);
+
+			__m256i r = _mm256_packs_epi32(_mm256_unpacklo_epi32(r0, r1), _mm256_unpackhi_epi32(r0, r1));
+			__m256i g = _mm256_packs_epi32(_mm256_unpacklo_epi32(g0, g1), _mm256_unpackhi_epi32(g0, g1));
+			__m256i b = _mm256_packs_epi32(_mm256_unpacklo_epi32(b0, b1), _mm256_unpackhi_epi32(b0, b1));
+
+			__m256i rb = _mm256_packus_epi16(r, b);
+			__m256i ga = _mm256_packus_epi16(g, alpha);
+			__m256i rg = _mm256_unpacklo_epi8(rb, ga);
+			__m256i ba = _mm256_unpackhi_epi8(rb, ga);
+			__m256i lo = _mm256_unpacklo_epi16(rg, ba); // pixels 0-3, 8-11
+			__m256i hi = _mm256_unpackhi_epi16(rg, ba); // pixels 4-7, 12-15
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba), _mm256_permute2x128_si256(lo, hi, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+
+			yuv  += 32;
+			rgba += 64;
+		}
+
+		if (x < width)
+			uyvy_rgba_row_sse2(yuv, rgba, width - x, c, bSwapRB);
+	}
+
+#endif // OFXNDI_X86
+
+	//
+	//        YUV422_to_RGBA
+	//
+	// Y sampled at every pixel
+	// U and V sampled at every second pixel 
+	//
+	// Flip, BGRA output and destination pitch in the same pass.
+	//
+	// 1920x1080 : 6.3 msec scalar, 1.6 msec SSE2, 1.0 msec AVX2
+	void YUV422_to_RGBA(const unsigned char* yuvsource,	unsigned char* rgbadest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		bool bInvert, bool bSwapRB, unsigned int destPitch,
+		ofxNDIcolormatrix matrix, ofxNDIcolorrange range)
+	{
+		if (!yuvsource || !rgbadest || width == 0)
+			return;
+
+		const YUVcoefficients &c = YUVselect(matrix, range, width);
+
+		// YUV data (NDIlib_FourCC_type_UYVA) is half width 
+		if (stride == 0) stride = ((width+1)/2)*4;
+		if (destPitch == 0) destPitch = width*4;
+
+		ParallelRows(width, height, destPitch, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				const unsigned char* yuv = yuvsource + (size_t)y * stride;
+				unsigned char* rgba = rgbadest + (size_t)(bInvert ? height - 1 - y : y) * destPitch;
+				Kernels().uyvy_rgba(yuv, rgba, width, c, bSwapRB);
+			}
+		});
+	} // end YUV422_to_RGBA
+
+	//
+	//        Scaled conversion
+	//
+	// Convert and scale in one pass for reduced size tiles.
+	// Exact reduction by 2, 4 or 8 averages each block of source pixels (box filter).
+	// Other sizes are sampled bilinear from the nearest four source pixels.
+	//
+	// Source lines are first combined vertically in a line buffer (SIMD).
+	// UYVY is then reduced horizontally to a UYVY line of the destination
+	// width and converted by the UYVY function for the SIMD level,
+	// so that only the destination pixels are converted to RGB.
+	//
+
+	// Sum of "rows" lines for each byte
+	// Up to 8 lines for a 16 bit sum without overflow
+	static void vsum_rows(const unsigned char* src, size_t stride, unsigned int rows, uint16_t* sum, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; i++)
+			sum[i] = src[i];
+		for (unsigned int r = 1; r < rows; r++) {
+			const unsigned char* line = src + r * stride;
+			for (size_t i = 0; i < bytes; i++)
+				sum[i] = (uint16_t)(sum[i] + line[i]);
+		}
+	}
+
+	// Interpolate between two lines with weight w (0-128) for the second
+	static void lerp_rows(const unsigned char* a, const unsigned char* b, unsigned char* dst, size_t bytes, int w)
+	{
+		for (size_t i = 0; i < bytes; i++)
+			dst[i] = (unsigned char)(a[i] + ((((int)b[i] - (int)a[i]) * w + 64) >> 7));
+	}
+
+	// Add pairs of UYVY macropixel sums in place for half the width.
+	// U and V of both, Y of the first and Y of the second macropixel.
+	static void uyvy_box_reduce(uint16_t* sum, unsigned int macropixels)
+	{
+		uint16_t* dst = sum;
+		for (unsigned int i = 0; i + 1 < macropixels; i += 2) {
+			const uint16_t* p = sum + (size_t)i*4;
+			dst[0] = (uint16_t)(p[0] + p[4]);
+			dst[1] = (uint16_t)(p[1] + p[3]);
+			dst[2] = (uint16_t)(p[2] + p[6]);
+			dst[3] = (uint16_t)(p[5] + p[7]);
+			dst += 4;
+		}
+	}
+
+	// Add pairs of RGBA pixel sums in place for half the width
+	static void rgba_box_reduce(uint16_t* sum, unsigned int pixels)
+	{
+		uint16_t* dst = sum;
+		for (unsigned int i = 0; i + 1 < pixels; i += 2) {
+			const uint16_t* p = sum + (size_t)i*4;
+			dst[0] = (uint16_t)(p[0] + p[4]);
+			dst[1] = (uint16_t)(p[1] + p[5]);
+			dst[2] = (uint16_t)(p[2] + p[6]);
+			dst[3] = (uint16_t)(p[3] + p[7]);
+			dst += 4;
+		}
+	}
+
+	// Divide sums by 1 << shift with rounding
+	static void box_pack(const uint16_t* sum, unsigned char* dst, size_t n, unsigned int shift)
+	{
+		const unsigned int half = 1u << (shift - 1);
+		for (size_t i = 0; i < n; i++)
+			dst[i] = (unsigned char)((sum[i] + half) >> shift);
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	static void vsum_rows_sse2(const unsigned char* src, size_t stride, unsigned int rows, uint16_t* sum, size_t bytes)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 16 <= bytes; i += 16) {
+			__m128i lo = zero;
+			__m128i hi = zero;
+			const unsigned char* line = src + i;
+			for (unsigned int r = 0; r < rows; r++) {
+				__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line));
+				lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+				hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+				line += stride;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sum + i),     lo);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sum + i + 8), hi);
+		}
+		if (i < bytes)
+			vsum_rows(src + i, stride, rows, sum + i, bytes - i);
+	}
+
+	// a + ((b - a)*w + 64) >> 7 in 16 bits. |(b - a)*w| is less than 32768.
+	static void lerp_rows_sse2(const unsigned char* a, const unsigned char* b, unsigned char* dst, size_t bytes, int w)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i weight = _mm_set1_epi16((short)w);
+		const __m128i round = _mm_set1_epi16(64);
+		size_t i = 0;
+		for (; i + 16 <= bytes; i += 16) {
+			__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			__m128i alo = _mm_unpacklo_epi8(va, zero);
+			__m128i ahi = _mm_unpackhi_epi8(va, zero);
+			__m128i dlo = _mm_sub_epi16(_mm_unpacklo_epi8(vb, zero), alo);
+			__m128i dhi = _mm_sub_epi16(_mm_unpackhi_epi8(vb, zero), ahi);
+			dlo = _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(dlo, weight), round), 7);
+			dhi = _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(dhi, weight), round), 7);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+				_mm_packus_epi16(_mm_add_epi16(alo, dlo), _mm_add_epi16(ahi, dhi)));
+		}
+		if (i < bytes)
+			lerp_rows(a + i, b + i, dst + i, bytes - i, w);
+	}
+
+	// Two output macropixels from four in each loop
+	static void uyvy_box_reduce_sse2(uint16_t* sum, unsigned int macropixels)
+	{
+		const __m128i uvmask = _mm_set_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+		const __m128i y0mask = _mm_set_epi16(0, 0, -1, 0, 0, 0, -1, 0);
+		const __m128i y1mask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+		unsigned int i = 0;
+		for (; i + 4 <= macropixels; i += 4) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + (size_t)i*4));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + (size_t)i*4 + 8));
+			// First and second macropixel of each pair
+			__m128i x = _mm_unpacklo_epi64(a, b);
+			__m128i y = _mm_unpackhi_epi64(a, b);
+			__m128i uv = _mm_add_epi16(x, y);
+			// Y0+Y1 of each macropixel in lanes 1 and 3
+			__m128i xs = _mm_add_epi16(x, _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(1, 2, 3, 0)), _MM_SHUFFLE(1, 2, 3, 0)));
+			__m128i ys = _mm_add_epi16(y, _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, _MM_SHUFFLE(1, 2, 3, 0)), _MM_SHUFFLE(1, 2, 3, 0)));
+			__m128i r = _mm_or_si128(_mm_and_si128(uv, uvmask), _mm_or_si128(_mm_and_si128(xs, y0mask), _mm_and_si128(ys, y1mask)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sum + (size_t)i*2), r);
+		}
+		if (i < macropixels) {
+			// The remaining pair is after the output so far
+			uyvy_box_reduce(sum + (size_t)i*4, macropixels - i);
+			memmove(sum + (size_t)i*2, sum + (size_t)i*4, (size_t)(macropixels - i)/2 * 4 * sizeof(uint16_t));
+		}
+	}
+
+	// Two output pixels from four in each loop
+	static void rgba_box_reduce_sse2(uint16_t* sum, unsigned int pixels)
+	{
+		unsigned int i = 0;
+		for (; i + 4 <= pixels; i += 4) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + (size_t)i*4));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + (size_t)i*4 + 8));
+			__m128i r = _mm_add_epi16(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(sum + (size_t)i*2), r);
+		}
+		if (i < pixels) {
+			rgba_box_reduce(sum + (size_t)i*4, pixels - i);
+			memmove(sum + (size_t)i*2, sum + (size_t)i*4, (size_t)(pixels - i)/2 * 4 * sizeof(uint16_t));
+		}
+	}
+
+	static void box_pack_sse2(const uint16_t* sum, unsigned char* dst, size_t n, unsigned int shift)
+	{
+		const __m128i half = _mm_set1_epi16((short)(1u << (shift - 1)));
+		const __m128i count = _mm_cvtsi32_si128((int)shift);
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16) {
+			__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + i));
+			__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sum + i + 8));
+			lo = _mm_srl_epi16(_mm_add_epi16(lo, half), count);
+			hi = _mm_srl_epi16(_mm_add_epi16(hi, half), count);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+		}
+		if (i < n)
+			box_pack(sum + i, dst + i, n - i, shift);
+	}
+
+#endif
+
+	// Box filter factor 2, 4 or 8 if the source is an exact multiple
+	// of the destination size, otherwise 0 for bilinear.
+	// The destination width must be even so that UYVY
+	// macropixels can be added in pairs.
+	static unsigned int BoxFactor(unsigned int width, unsigned int height, unsigned int destWidth, unsigned int destHeight)
+	{
+		if (destWidth & 1)
+			return 0;
+		for (unsigned int f = 2; f <= 8; f *= 2) {
+			if (width == destWidth*f && height == destHeight*f)
+				return f;
+		}
+		return 0;
+	}
+
+	// Bilinear sample positions
+	// Pixel centres are aligned so that the image is not shifted.
+	// Index of the first of two samples and the weight (0-128) of the second.
+	struct scaletap {
+		unsigned int i0;
+		unsigned int i1;
+		int w;
+	};
+
+	static void ScaleTaps(std::vector<scaletap> &taps, unsigned int size, unsigned int destSize, double scale)
+	{
+		taps.resize(destSize);
+		for (unsigned int d = 0; d < destSize; d++) {
+			double s = ((double)d + 0.5) * scale - 0.5;
+			s = std::min(std::max(s, 0.0), (double)(size - 1));
+			unsigned int i0 = (unsigned int)s;
+			taps[d].i0 = i0;
+			taps[d].i1 = std::min(i0 + 1, size - 1);
+			taps[d].w  = (int)((s - (double)i0) * 128.0 + 0.5);
+		}
+	}
+
+	static inline unsigned char Lerp(int a, int b, int w)
+	{
+		return (unsigned char)(a + (((b - a) * w + 64) >> 7));
+	}
+
+	// Convert UYVY to RGBA or BGRA (bSwapRB) scaled to destWidth x destHeight
+	// Chroma of each destination pixel pair is filtered from the
+	// source macropixels that the pair covers.
+	// 1920x1080 to 480x270 : 0.5 msec box filter, to 576x324 : 0.85 msec bilinear
+	// Full size YUV422_to_RGBA : 0.9 msec (AVX2, one thread)
+	void YUV422_to_RGBA_scaled(const unsigned char* yuvsource, unsigned char* rgbadest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		unsigned int destWidth, unsigned int destHeight,
+		bool bInvert, bool bSwapRB, unsigned int destPitch,
+		ofxNDIcolormatrix matrix, ofxNDIcolorrange range, const ofxNDIlut* lut)
+	{
+		if (!yuvsource || !rgbadest || width == 0 || height == 0 || destWidth == 0 || destHeight == 0)
+			return;
+		if (!LUTused(lut)) lut = nullptr;
+
+		// Matrix for the source size
+		const YUVcoefficients &c = YUVselect(matrix, range, width);
+
+		const size_t linebytes = (size_t)((width+1)/2)*4;
+		if (stride == 0) stride = (unsigned int)linebytes;
+		if (destPitch == 0) destPitch = destWidth*4;
+		const unsigned int destPairs = (destWidth+1)/2;
+
+		const unsigned int f = BoxFactor(width, height, destWidth, destHeight);
+		if (f > 0) {
+			// f*f luma and chroma samples for each destination pixel or pixel pair
+			const unsigned int shift = (f == 2) ? 2 : (f == 4) ? 4 : 6;
+			// Work is in proportion to the source lines read for each band
+			ParallelRows(width*f, destHeight, (size_t)stride*f, [&](unsigned int y0, unsigned int y1) {
+				std::vector<uint16_t> sum(linebytes);
+				std::vector<unsigned char> uyvy((size_t)destPairs*4);
+				for (unsigned int y = y0; y < y1; y++) {
+					// Vertical sum of f lines
+					Kernels().vsum_rows(yuvsource + (size_t)y * f * stride, stride, f, sum.data(), linebytes);
+					// Halve the width until each macropixel is a destination pixel pair
+					for (unsigned int n = width/2; n > destPairs; n /= 2)
+						Kernels().uyvy_box_reduce(sum.data(), n);
+					Kernels().box_pack(sum.data(), uyvy.data(), (size_t)destPairs*4, shift);
+					unsigned char* rgba = rgbadest + (size_t)(bInvert ? destHeight - 1 - y : y) * destPitch;
+					Kernels().uyvy_rgba(uyvy.data(), rgba, destWidth, c, bSwapRB);
+					if (lut)
+						Kernels().lut_rgba(*lut, rgba, rgba, destWidth);
+				}
+			});
+			return;
+		}
+
+		// Bilinear
+		// Luma at each destination pixel, chroma at the centre of each pixel pair
+		std::vector<scaletap> xtaps, ctaps, ytaps;
+		const double xscale = (double)width / (double)destWidth;
+		ScaleTaps(xtaps, width, destWidth, xscale);
+		ScaleTaps(ctaps, (width+1)/2, destPairs, xscale);
+		ScaleTaps(ytaps, height, destHeight, (double)height / (double)destHeight);
+
+		// Source byte offsets and weight for each byte of the destination UYVY line
+		// U at byte 0, Y at bytes 1 and 3, V at byte 2 of each macropixel
+		const size_t nbytes = (size_t)destPairs*4;
+		std::vector<scaletap> btaps(nbytes);
+		for (unsigned int p = 0; p < destPairs; p++) {
+			const scaletap &tc = ctaps[p];
+			const scaletap &ta = xtaps[p*2];
+			const scaletap &tb = xtaps[std::min(p*2 + 1, destWidth - 1)];
+			scaletap* t = &btaps[(size_t)p*4];
+			t[0] = { tc.i0*4,     tc.i1*4,     tc.w };
+			t[1] = { ta.i0*2 + 1, ta.i1*2 + 1, ta.w };
+			t[2] = { tc.i0*4 + 2, tc.i1*4 + 2, tc.w };
+			t[3] = { tb.i0*2 + 1, tb.i1*2 + 1, tb.w };
+		}
+
+		ParallelRows(destWidth, destHeight, linebytes*2, [&](unsigned int y0, unsigned int y1) {
+			std::vector<unsigned char> line(linebytes);
+			std::vector<unsigned char> uyvy(nbytes);
+			for (unsigned int y = y0; y < y1; y++) {
+				// Vertical then horizontal
+				const scaletap &ty = ytaps[y];
+				const unsigned char* src = yuvsource + (size_t)ty.i0 * stride;
+				if (ty.w > 0) {
+					Kernels().lerp_rows(src, yuvsource + (size_t)ty.i1 * stride, line.data(), linebytes, ty.w);
+					src = line.data();
+				}
+				for (size_t i = 0; i < nbytes; i++)
+					uyvy[i] = Lerp(src[btaps[i].i0], src[btaps[i].i1], btaps[i].w);
+				unsigned char* rgba = rgbadest + (size_t)(bInvert ? destHeight - 1 - y : y) * destPitch;
+				Kernels().uyvy_rgba(uyvy.data(), rgba, destWidth, c, bSwapRB);
+				if (lut)
+					Kernels().lut_rgba(*lut, rgba, rgba, destWidth);
+			}
+		});
+	} // end YUV422_to_RGBA_scaled
+
+	// Scale RGBA or BGRA pixels to destWidth x destHeight
+	// Option swap red and blue (bSwapRB) and flip in the same pass
+	// Lookup table and alpha for each destination line
+	void ScaleImage(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		unsigned int destWidth, unsigned int destHeight,
+		bool bInvert, bool bSwapRB, unsigned int destPitch,
+		const ofxNDIlut* lut, ofxNDIalphamode alpha)
+	{
+		if (!source || !dest || width == 0 || height == 0 || destWidth == 0 || destHeight == 0)
+			return;
+		if (!LUTused(lut)) lut = nullptr;
+		const bool bGrade = (lut || alpha != alpha_none);
+
+		const size_t linebytes = (size_t)width*4;
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = destWidth*4;
+
+		const int ri = bSwapRB ? 2 : 0;
+		const int bi = 2 - ri;
+
+		const unsigned int f = BoxFactor(width, height, destWidth, destHeight);
+		if (f > 0) {
+			const unsigned int shift = (f == 2) ? 2 : (f == 4) ? 4 : 6;
+			ParallelRows(width*f, destHeight, (size_t)sourcePitch*f, [&](unsigned int y0, unsigned int y1) {
+				std::vector<uint16_t> sum(linebytes);
+				for (unsigned int y = y0; y < y1; y++) {
+					Kernels().vsum_rows(source + (size_t)y * f * sourcePitch, sourcePitch, f, sum.data(), linebytes);
+					for (unsigned int n = width; n > destWidth; n /= 2)
+						Kernels().rgba_box_reduce(sum.data(), n);
+					unsigned char* rgba = dest + (size_t)(bInvert ? destHeight - 1 - y : y) * destPitch;
+					Kernels().box_pack(sum.data(), rgba, (size_t)destWidth*4, shift);
+					// Swap in place
+					if (bSwapRB)
+						Kernels().rgba_bgra(reinterpret_cast<const uint32_t*>(rgba), reinterpret_cast<uint32_t*>(rgba), destWidth);
+					if (bGrade)
+						GradeRow(lut, alpha, rgba, destWidth);
+				}
+			});
+			return;
+		}
+
+		// Bilinear
+		std::vector<scaletap> xtaps, ytaps;
+		ScaleTaps(xtaps, width, destWidth, (double)width / (double)destWidth);
+		ScaleTaps(ytaps, height, destHeight, (double)height / (double)destHeight);
+
+		ParallelRows(destWidth, destHeight, linebytes*2, [&](unsigned int y0, unsigned int y1) {
+			std::vector<unsigned char> line(linebytes);
+			for (unsigned int y = y0; y < y1; y++) {
+				const scaletap &ty = ytaps[y];
+				const unsigned char* src = source + (size_t)ty.i0 * sourcePitch;
+				if (ty.w > 0) {
+					Kernels().lerp_rows(src, source + (size_t)ty.i1 * sourcePitch, line.data(), linebytes, ty.w);
+					src = line.data();
+				}
+				unsigned char* rgba = dest + (size_t)(bInvert ? destHeight - 1 - y : y) * destPitch;
+				for (unsigned int x = 0; x < destWidth; x++) {
+					const scaletap &tx = xtaps[x];
+					const unsigned char* p0 = src + (size_t)tx.i0 * 4;
+					const unsigned char* p1 = src + (size_t)tx.i1 * 4;
+					rgba[ri] = Lerp(p0[0], p1[0], tx.w);
+					rgba[1]  = Lerp(p0[1], p1[1], tx.w);
+					rgba[bi] = Lerp(p0[2], p1[2], tx.w);
+					rgba[3]  = Lerp(p0[3], p1[3], tx.w);
+					rgba += 4;
+				}
+				if (bGrade)
+					GradeRow(lut, alpha, rgba - (size_t)destWidth*4, destWidth);
+			}
+		});
+	} // end ScaleImage
+
+	//
+	//        NV12, I420 and YV12 to RGBA
+	//
+	// 4:2:0 lines are interleaved to UYVY in a line buffer
+	// and converted by the UYVY function for the SIMD level.
+	// One chroma line is shared by two Y lines.
+	// Odd widths and heights use the last chroma sample and line.
+	//
+
+	// Scalar reference
+	static void nv12_uyvy_row(const unsigned char* y, const unsigned char* uv, unsigned char* uyvy, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x += 2) {
+			uyvy[0] = uv[0];
+			uyvy[1] = y[0];
+			uyvy[2] = uv[1];
+			uyvy[3] = (x + 1 < width) ? y[1] : y[0];
+			y    += 2;
+			uv   += 2;
+			uyvy += 4;
+		}
+	}
+
+	static void i420_uyvy_row(const unsigned char* y, const unsigned char* u, const unsigned char* v, unsigned char* uyvy, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x += 2) {
+			uyvy[0] = *u++;
+			uyvy[1] = y[0];
+			uyvy[2] = *v++;
+			uyvy[3] = (x + 1 < width) ? y[1] : y[0];
+			y    += 2;
+			uyvy += 4;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// SSE2 - 16 pixels per loop
+	static void nv12_uyvy_row_sse2(const unsigned char* y, const unsigned char* uv, unsigned char* uyvy, unsigned int width)
+	{
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i yy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+			__m128i cc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv)); // u v u v
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(uyvy), _mm_unpacklo_epi8(cc, yy));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(uyvy + 16), _mm_unpackhi_epi8(cc, yy));
+			y    += 16;
+			uv   += 16;
+			uyvy += 32;
+		}
+		if (x < width)
+			nv12_uyvy_row(y, uv, uyvy, width - x);
+	}
+
+	static void i420_uyvy_row_sse2(const unsigned char* y, const unsigned char* u, const unsigned char* v, unsigned char* uyvy, unsigned int width)
+	{
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i yy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+			__m128i uu = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u));
+			__m128i vv = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v));
+			__m128i cc = _mm_unpacklo_epi8(uu, vv); // u v u v
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(uyvy), _mm_unpacklo_epi8(cc, yy));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(uyvy + 16), _mm_unpackhi_epi8(cc, yy));
+			y    += 16;
+			u    += 8;
+			v    += 8;
+			uyvy += 32;
+		}
+		if (x < width)
+			i420_uyvy_row(y, u, v, uyvy, width - x);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+	// Pixels per line buffer pass (even)
+	static const unsigned int YUV420_CHUNK = 1024;
+
+	// Convert first pixel of a UYVY line that starts at the second pixel of a macropixel
+	// (region with odd left edge) followed by the remaining n-2 pixels
+	static void uyvy_rgba_skip(const unsigned char* uyvy, unsigned char* rgba, unsigned int n, const YUVcoefficients &c)
+	{
+		unsigned char pair[8];
+		Kernels().uyvy_rgba(uyvy, pair, 2, c, false);
+		memcpy(rgba, pair + 4, 4);
+		if (n > 2)
+			Kernels().uyvy_rgba(uyvy + 4, rgba + 4, n - 2, c, false);
+	}
+
+	// Convert 4:2:0 planes to RGBA
+	// For NV12, v is null and u is the interleaved UV plane
+	// left and top are the origin of a region within the planes
+	// Option lookup table for each line
+	static void YUV420_to_RGBA(const unsigned char* yplane, unsigned int ystride,
+		const unsigned char* uplane, const unsigned char* vplane, unsigned int uvstride,
+		unsigned char* rgbadest, unsigned int destPitch, unsigned int width, unsigned int height, bool bInvert,
+		const YUVcoefficients &c, unsigned int left = 0, unsigned int top = 0, const ofxNDIlut* lut = nullptr)
+	{
+		// Start at the macropixel of the left edge
+		const unsigned int skip = left & 1;
+		const unsigned int xe = left - skip;
+		const unsigned int total = width + skip;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			unsigned char uyvy[YUV420_CHUNK*2];
+			for (unsigned int y = y0; y < y1; y++) {
+				const unsigned int sy = top + y;
+				const unsigned char* py = yplane + (size_t)sy * ystride + xe;
+				const unsigned char* pu = uplane + (size_t)(sy/2) * uvstride + (vplane ? xe/2 : xe);
+				const unsigned char* pv = vplane ? vplane + (size_t)(sy/2) * uvstride + xe/2 : nullptr;
+				unsigned char* rgba = rgbadest + (size_t)(bInvert ? height - 1 - y : y) * destPitch;
+				for (unsigned int x = 0; x < total; x += YUV420_CHUNK) {
+					unsigned int n = std::min(total - x, YUV420_CHUNK);
+					if (pv)
+						Kernels().i420_uyvy(py + x, pu + x/2, pv + x/2, uyvy, n);
+					else
+						Kernels().nv12_uyvy(py + x, pu + x, uyvy, n);
+					if (x == 0 && skip)
+						uyvy_rgba_skip(uyvy, rgba, n, c);
+					else
+						Kernels().uyvy_rgba(uyvy, rgba + (size_t)(x - skip) * 4, n, c, false);
+				}
+				if (lut)
+					Kernels().lut_rgba(*lut, rgba, rgba, width);
+			}
+		});
+	}
+
+	// NV12 - Y plane followed by interleaved UV at half height.
+	// Both planes have the same line pitch.
+	// 1920x1080 : 15 msec scalar, 3.3 msec SSE2, 2.2 msec AVX2
+	void NV12_to_RGBA(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int stride, bool bInvert,
+		unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range)
+	{
+		if (!source || !dest || width == 0)
+			return;
+		if (stride == 0) stride = width;
+		if (destPitch == 0) destPitch = width*4;
+		YUV420_to_RGBA(source, stride, source + (size_t)stride * height, nullptr, stride,
+			dest, destPitch, width, height, bInvert, YUVselect(matrix, range, width));
+	} // end NV12_to_RGBA
+
+	// I420 - Y plane followed by U and V planes at half height and half pitch.
+	// YV12 - V and U planes are swapped.
+	void I420_to_RGBA(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int stride, bool bYV12, bool bInvert,
+		unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range)
+	{
+		if (!source || !dest || width == 0)
+			return;
+		if (stride == 0) stride = width;
+		if (destPitch == 0) destPitch = width*4;
+		const unsigned int uvstride = (stride+1)/2;
+		const unsigned char* p1 = source + (size_t)stride * height;
+		const unsigned char* p2 = p1 + (size_t)uvstride * ((height+1)/2);
+		const YUVcoefficients &c = YUVselect(matrix, range, width);
+		if (bYV12)
+			YUV420_to_RGBA(source, stride, p2, p1, uvstride, dest, destPitch, width, height, bInvert, c);
+		else
+			YUV420_to_RGBA(source, stride, p1, p2, uvstride, dest, destPitch, width, height, bInvert, c);
+	} // end I420_to_RGBA
+
+	//
+	//        P216 and PA16 to RGBA
+	//
+	// 16 bit 4:2:2. Y plane followed by interleaved UV at half width
+	// with the same line pitch. PA16 adds an alpha plane after UV.
+	// Limited range : Y 4096-60160, U and V 4096-61440 centred on 32768.
+	//
+	// Calculation is in float to retain 16 bit precision.
+	// The matrix is applied without a transfer function (PQ/HLG).
+	//
+
+	// Coefficients scaled to the output range (65535 or 255)
+	struct P216coefficients {
+		float y;  // Y to RGB
+		float vr; // V to R
+		float ug; // U to G
+		float vg; // V to G
+		float ub; // U to B
+		float r, g, b; // Offsets for Y - 4096, U and V - 32768
+	};
+
+	static P216coefficients P216matrix(ofxNDIcolormatrix matrix, ofxNDIcolorrange range, unsigned int width, float scale)
+	{
+		// SD BT.601, HD BT.709, UHD BT.2020 as for RGBA_to_YUV422
+		matrix = AutoMatrix(matrix, width);
+		const double K[3][2] = { { 0.299, 0.114 }, { 0.2126, 0.0722 }, { 0.2627, 0.0593 } };
+		const double kr = K[matrix][0];
+		const double kb = K[matrix][1];
+		const double kg = 1.0 - kr - kb;
+		const bool bFull = (range == range_full);
+		const double ys = scale / (bFull ? 65535.0 : 56064.0); // (235-16)*256
+		const double cs = scale / (bFull ? 65535.0 : 57344.0); // (240-16)*256
+		const double yoffset = bFull ? 0.0 : 4096.0;
+		P216coefficients c{};
+		c.y  = (float)ys;
+		c.vr = (float)(cs * 2.0 * (1.0 - kr));
+		c.ug = (float)(-cs * 2.0 * kb * (1.0 - kb) / kg);
+		c.vg = (float)(-cs * 2.0 * kr * (1.0 - kr) / kg);
+		c.ub = (float)(cs * 2.0 * (1.0 - kb));
+		c.r  = (float)(-yoffset * c.y - 32768.0 * c.vr);
+		c.g  = (float)(-yoffset * c.y - 32768.0 * (c.ug + c.vg));
+		c.b  = (float)(-yoffset * c.y - 32768.0 * c.ub);
+		return c;
+	}
+
+	// 4x4 ordered dither thresholds for 8 bit output (-0.5 to 0.5)
+	static const float DitherMatrix[4][4] = {
+		{ -0.46875f,  0.03125f, -0.34375f,  0.15625f },
+		{  0.28125f, -0.21875f,  0.40625f, -0.09375f },
+		{ -0.28125f,  0.21875f, -0.40625f,  0.09375f },
+		{  0.46875f, -0.03125f,  0.34375f, -0.15625f }
+	};
+	static const float NoDither[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	static inline float p216_r(const P216coefficients &c, float y, float v)
+	{
+		return (c.y*y + c.vr*v) + c.r;
+	}
+
+	static inline float p216_g(const P216coefficients &c, float y, float u, float v)
+	{
+		return ((c.y*y + c.ug*u) + c.vg*v) + c.g;
+	}
+
+	static inline float p216_b(const P216coefficients &c, float y, float u)
+	{
+		return (c.y*y + c.ub*u) + c.b;
+	}
+
+	static inline int clampi(long v, int max)
+	{
+		return v < 0 ? 0 : (v > max ? max : (int)v);
+	}
+
+	// Scalar reference - RGBA16
+	// alpha is null for P216
+	static void p216_rgba16_row(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		uint16_t* rgba, unsigned int width, const P216coefficients &c)
+	{
+		for (unsigned int x = 0; x < width; x++) {
+			float fy = (float)y[x];
+			float fu = (float)uv[x & ~1u];
+			float fv = (float)uv[(x & ~1u) + 1];
+			rgba[0] = (uint16_t)clampi(lrintf(p216_r(c, fy, fv)), 65535);
+			rgba[1] = (uint16_t)clampi(lrintf(p216_g(c, fy, fu, fv)), 65535);
+			rgba[2] = (uint16_t)clampi(lrintf(p216_b(c, fy, fu)), 65535);
+			rgba[3] = alpha ? alpha[x] : 65535;
+			rgba += 4;
+		}
+	}
+
+	// Scalar reference - RGBA8
+	// dither holds the 4 thresholds for the line
+	static void p216_rgba8_row(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		unsigned char* rgba, unsigned int width, const P216coefficients &c, const float* dither)
+	{
+		for (unsigned int x = 0; x < width; x++) {
+			float fy = (float)y[x];
+			float fu = (float)uv[x & ~1u];
+			float fv = (float)uv[(x & ~1u) + 1];
+			float d  = dither[x & 3];
+			rgba[0] = (unsigned char)clampi(lrintf(p216_r(c, fy, fv) + d), 255);
+			rgba[1] = (unsigned char)clampi(lrintf(p216_g(c, fy, fu, fv) + d), 255);
+			rgba[2] = (unsigned char)clampi(lrintf(p216_b(c, fy, fu) + d), 255);
+			rgba[3] = alpha ? (unsigned char)(alpha[x] >> 8) : 255;
+			rgba += 4;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	//
+	// SSE2 - 8 pixels per loop
+	//
+	// Y, U and V are widened to 32 bit, converted to float and
+	// the results rounded back to int32 as for lrintf.
+	// 16 bit unsigned saturation uses signed packing with a 32768 bias.
+	//
+	struct p216_sse2 {
+		__m128 r[2], g[2], b[2]; // pixels 0-3, 4-7
+	};
+
+	static inline p216_sse2 p216_calc_sse2(const uint16_t* y, const uint16_t* uv, const P216coefficients &c)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i yv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+		__m128i cv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uv)); // u0 v0 u1 v1 u2 v2 u3 v3
+		__m128i u  = _mm_and_si128(cv, _mm_set1_epi32(0xFFFF));
+		__m128i v  = _mm_srli_epi32(cv, 16);
+
+		__m128 fy[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi16(yv, zero)), _mm_cvtepi32_ps(_mm_unpackhi_epi16(yv, zero)) };
+		__m128 fu[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi32(u, u)), _mm_cvtepi32_ps(_mm_unpackhi_epi32(u, u)) };
+		__m128 fv[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi32(v, v)), _mm_cvtepi32_ps(_mm_unpackhi_epi32(v, v)) };
+
+		const __m128 ky = _mm_set1_ps(c.y), kvr = _mm_set1_ps(c.vr), kug = _mm_set1_ps(c.ug);
+		const __m128 kvg = _mm_set1_ps(c.vg), kub = _mm_set1_ps(c.ub);
+		const __m128 kr = _mm_set1_ps(c.r), kg = _mm_set1_ps(c.g), kb = _mm_set1_ps(c.b);
+
+		p216_sse2 p;
+		for (int i = 0; i < 2; i++) {
+			__m128 yy = _mm_mul_ps(ky, fy[i]);
+			p.r[i] = _mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(kvr, fv[i])), kr);
+			p.g[i] = _mm_add_ps(_mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(kug, fu[i])), _mm_mul_ps(kvg, fv[i])), kg);
+			p.b[i] = _mm_add_ps(_mm_add_ps(yy, _mm_mul_ps(kub, fu[i])), kb);
+		}
+		return p;
+	}
+
+	// Round and pack 8 floats to unsigned 16 bit
+	static inline __m128i pack_u16_sse2(__m128 lo, __m128 hi)
+	{
+		const __m128i bias = _mm_set1_epi32(32768);
+		__m128i a = _mm_sub_epi32(_mm_cvtps_epi32(lo), bias);
+		__m128i b = _mm_sub_epi32(_mm_cvtps_epi32(hi), bias);
+		return _mm_xor_si128(_mm_packs_epi32(a, b), _mm_set1_epi16((short)0x8000));
+	}
+
+	static void p216_rgba16_row_sse2(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		uint16_t* rgba, unsigned int width, const P216coefficients &c)
+	{
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			p216_sse2 p = p216_calc_sse2(y + x, uv + x, c);
+			__m128i r = pack_u16_sse2(p.r[0], p.r[1]);
+			__m128i g = pack_u16_sse2(p.g[0], p.g[1]);
+			__m128i b = pack_u16_sse2(p.b[0], p.b[1]);
+			__m128i a = alpha ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + x)) : _mm_set1_epi16(-1);
+			__m128i rg = _mm_unpacklo_epi16(r, g);
+			__m128i ba = _mm_unpacklo_epi16(b, a);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba),      _mm_unpacklo_epi32(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 8),  _mm_unpackhi_epi32(rg, ba));
+			rg = _mm_unpackhi_epi16(r, g);
+			ba = _mm_unpackhi_epi16(b, a);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 16), _mm_unpacklo_epi32(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 24), _mm_unpackhi_epi32(rg, ba));
+			rgba += 32;
+		}
+		if (x < width)
+			p216_rgba16_row(y + x, uv + x, alpha ? alpha + x : nullptr, rgba, width - x, c);
+	}
+
+	static void p216_rgba8_row_sse2(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		unsigned char* rgba, unsigned int width, const P216coefficients &c, const float* dither)
+	{
+		const __m128 d = _mm_loadu_ps(dither);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			p216_sse2 p = p216_calc_sse2(y + x, uv + x, c);
+			__m128i r = _mm_packs_epi32(_mm_cvtps_epi32(_mm_add_ps(p.r[0], d)), _mm_cvtps_epi32(_mm_add_ps(p.r[1], d)));
+			__m128i g = _mm_packs_epi32(_mm_cvtps_epi32(_mm_add_ps(p.g[0], d)), _mm_cvtps_epi32(_mm_add_ps(p.g[1], d)));
+			__m128i b = _mm_packs_epi32(_mm_cvtps_epi32(_mm_add_ps(p.b[0], d)), _mm_cvtps_epi32(_mm_add_ps(p.b[1], d)));
+			__m128i a = alpha ? _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + x)), 8) : _mm_set1_epi16(255);
+			__m128i rb = _mm_packus_epi16(r, b);
+			__m128i ga = _mm_packus_epi16(g, a);
+			__m128i rg = _mm_unpacklo_epi8(rb, ga);
+			__m128i ba = _mm_unpackhi_epi8(rb, ga);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba), _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + 16), _mm_unpackhi_epi16(rg, ba));
+			rgba += 32;
+		}
+		if (x < width)
+			p216_rgba8_row(y + x, uv + x, alpha ? alpha + x : nullptr, rgba, width - x, c, dither);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	//
+	// AVX2 - 16 pixels per loop
+	//
+	// Each 128 bit lane holds 8 pixels of the SSE2 method.
+	// Results are in lane order and re-ordered for the store.
+	//
+	struct p216_avx2 {
+		__m256 r[2], g[2], b[2]; // pixels 0-3, 8-11 and 4-7, 12-15
+	};
+
+	OFXNDI_TARGET_AVX2
+	static inline p216_avx2 p216_calc_avx2(const uint16_t* y, const uint16_t* uv, const P216coefficients &c)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i yv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y));
+		__m256i cv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(uv));
+		__m256i u  = _mm256_and_si256(cv, _mm256_set1_epi32(0xFFFF));
+		__m256i v  = _mm256_srli_epi32(cv, 16);
+
+		__m256 fy[2] = { _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(yv, zero)), _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(yv, zero)) };
+		__m256 fu[2] = { _mm256_cvtepi32_ps(_mm256_unpacklo_epi32(u, u)), _mm256_cvtepi32_ps(_mm256_unpackhi_epi32(u, u)) };
+		__m256 fv[2] = { _mm256_cvtepi32_ps(_mm256_unpacklo_epi32(v, v)), _mm256_cvtepi32_ps(_mm256_unpackhi_epi32(v, v)) };
+
+		const __m256 ky = _mm256_set1_ps(c.y), kvr = _mm256_set1_ps(c.vr), kug = _mm256_set1_ps(c.ug);
+		const __m256 kvg = _mm256_set1_ps(c.vg), kub = _mm256_set1_ps(c.ub);
+		const __m256 kr = _mm256_set1_ps(c.r), kg = _mm256_set1_ps(c.g), kb = _mm256_set1_ps(c.b);
+
+		p216_avx2 p;
+		for (int i = 0; i < 2; i++) {
+			__m256 yy = _mm256_mul_ps(ky, fy[i]);
+			p.r[i] = _mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(kvr, fv[i])), kr);
+			p.g[i] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(kug, fu[i])), _mm256_mul_ps(kvg, fv[i])), kg);
+			p.b[i] = _mm256_add_ps(_mm256_add_ps(yy, _mm256_mul_ps(kub, fu[i])), kb);
+		}
+		return p;
+	}
+
+	OFXNDI_TARGET_AVX2
+	static inline __m256i pack_u16_avx2(__m256 lo, __m256 hi)
+	{
+		const __m256i bias = _mm256_set1_epi32(32768);
+		__m256i a = _mm256_sub_epi32(_mm256_cvtps_epi32(lo), bias);
+		__m256i b = _mm256_sub_epi32(_mm256_cvtps_epi32(hi), bias);
+		return _mm256_xor_si256(_mm256_packs_epi32(a, b), _mm256_set1_epi16((short)0x8000));
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void p216_rgba16_row_avx2(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		uint16_t* rgba, unsigned int width, const P216coefficients &c)
+	{
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			p216_avx2 p = p216_calc_avx2(y + x, uv + x, c);
+			__m256i r = pack_u16_avx2(p.r[0], p.r[1]); // pixels 0-7 | 8-15
+			__m256i g = pack_u16_avx2(p.g[0], p.g[1]);
+			__m256i b = pack_u16_avx2(p.b[0], p.b[1]);
+			__m256i a = alpha ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(alpha + x)) : _mm256_set1_epi16(-1);
+			__m256i rg = _mm256_unpacklo_epi16(r, g);
+			__m256i ba = _mm256_unpacklo_epi16(b, a);
+			__m256i p0 = _mm256_unpacklo_epi32(rg, ba); // 0-1 | 8-9
+			__m256i p1 = _mm256_unpackhi_epi32(rg, ba); // 2-3 | 10-11
+			rg = _mm256_unpackhi_epi16(r, g);
+			ba = _mm256_unpackhi_epi16(b, a);
+			__m256i p2 = _mm256_unpacklo_epi32(rg, ba); // 4-5 | 12-13
+			__m256i p3 = _mm256_unpackhi_epi32(rg, ba); // 6-7 | 14-15
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba),      _mm256_permute2x128_si256(p0, p1, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 16), _mm256_permute2x128_si256(p2, p3, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 48), _mm256_permute2x128_si256(p2, p3, 0x31));
+			rgba += 64;
+		}
+		if (x < width)
+			p216_rgba16_row_sse2(y + x, uv + x, alpha ? alpha + x : nullptr, rgba, width - x, c);
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void p216_rgba8_row_avx2(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		unsigned char* rgba, unsigned int width, const P216coefficients &c, const float* dither)
+	{
+		const __m256 d = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(dither));
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			p216_avx2 p = p216_calc_avx2(y + x, uv + x, c);
+			__m256i r = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_add_ps(p.r[0], d)), _mm256_cvtps_epi32(_mm256_add_ps(p.r[1], d)));
+			__m256i g = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_add_ps(p.g[0], d)), _mm256_cvtps_epi32(_mm256_add_ps(p.g[1], d)));
+			__m256i b = _mm256_packs_epi32(_mm256_cvtps_epi32(_mm256_add_ps(p.b[0], d)), _mm256_cvtps_epi32(_mm256_add_ps(p.b[1], d)));
+			__m256i a = alpha ? _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(alpha + x)), 8) : _mm256_set1_epi16(255);
+			__m256i rb = _mm256_packus_epi16(r, b);
+			__m256i ga = _mm256_packus_epi16(g, a);
+			__m256i rg = _mm256_unpacklo_epi8(rb, ga);
+			__m256i ba = _mm256_unpackhi_epi8(rb, ga);
+			__m256i lo = _mm256_unpacklo_epi16(rg, ba); // pixels 0-3, 8-11
+			__m256i hi = _mm256_unpackhi_epi16(rg, ba); // pixels 4-7, 12-15
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba), _mm256_permute2x128_si256(lo, hi, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+			rgba += 64;
+		}
+		if (x < width)
+			p216_rgba8_row_sse2(y + x, uv + x, alpha ? alpha + x : nullptr, rgba, width - x, c, dither);
+	}
+
+#endif // OFXNDI_X86
+
+	//
+	//        P216_to_RGBA16
+	//
+	// 3840x2160 : 119 msec scalar, 22 msec SSE2, 16 msec AVX2
+	void P216_to_RGBA16(const unsigned char* source, unsigned short* dest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		bool bAlpha, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range)
+	{
+		if (!source || !dest || width == 0)
+			return;
+
+		if (stride == 0) stride = width*2;
+		if (destPitch == 0) destPitch = width*8;
+		const P216coefficients c = P216matrix(matrix, range, width, 65535.0f);
+		const unsigned char* uvplane = source + (size_t)stride * height;
+		const unsigned char* aplane  = uvplane + (size_t)stride * height;
+
+		ParallelRows(width, height, (size_t)width*8, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				const size_t line = (size_t)y * stride;
+				const uint16_t* a = bAlpha ? reinterpret_cast<const uint16_t*>(aplane + line) : nullptr;
+				uint16_t* rgba = reinterpret_cast<uint16_t*>(reinterpret_cast<unsigned char*>(dest)
+					+ (size_t)(bInvert ? height - 1 - y : y) * destPitch);
+				Kernels().p216_rgba16(reinterpret_cast<const uint16_t*>(source + line),
+					reinterpret_cast<const uint16_t*>(uvplane + line), a, rgba, width, c);
+			}
+		});
+	} // end P216_to_RGBA16
+
+	//
+	//        P216_to_RGBA
+	//
+	// 8 bit output with optional 4x4 ordered dither.
+	//
+	// 3840x2160 : 122 msec scalar, 17 msec SSE2, 13 msec AVX2
+	void P216_to_RGBA(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		bool bAlpha, bool bDither, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range,
+		ofxNDIalphamode alpha)
+	{
+		if (!source || !dest || width == 0)
+			return;
+
+		if (stride == 0) stride = width*2;
+		if (destPitch == 0) destPitch = width*4;
+		const P216coefficients c = P216matrix(matrix, range, width, 255.0f);
+		const unsigned char* uvplane = source + (size_t)stride * height;
+		const unsigned char* aplane  = uvplane + (size_t)stride * height;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				const size_t line = (size_t)y * stride;
+				const uint16_t* a = bAlpha ? reinterpret_cast<const uint16_t*>(aplane + line) : nullptr;
+				unsigned char* rgba = dest + (size_t)(bInvert ? height - 1 - y : y) * destPitch;
+				Kernels().p216_rgba8(reinterpret_cast<const uint16_t*>(source + line),
+					reinterpret_cast<const uint16_t*>(uvplane + line), a, rgba, width, c,
+					bDither ? DitherMatrix[y & 3] : NoDither);
+				if (a && alpha != alpha_none)
+					GradeRow(nullptr, alpha, rgba, width);
+			}
+		});
+	} // end P216_to_RGBA
+
+
+
+	//
+	//        RGBA_to_YUV422
+	//
+
+	//
+	// Integer coefficients for RGB to YUV
+	//
+	// Y  = 16  + 219/255 * (Kr*R + Kg*G + Kb*B)
+	// Cb = 128 + 224/255 * (B - Y) / (2 * (1-Kb))
+	// Cr = 128 + 224/255 * (R - Y) / (2 * (1-Kr))
+	//
+	// Scaled by 2^14 for 16 bit SIMD multiply-add.
+	// Coefficients are in source component order (RGBA or BGRA).
+	//
+	struct RGBcoefficients {
+		int16_t y[3]; // r, g, b to Y
+		int16_t u[3]; // r, g, b to Cb
+		int16_t v[3]; // r, g, b to Cr
+	};
+
+	static constexpr int16_t RGBcoef(double c)
+	{
+		return (int16_t)(c * 16384.0 + (c < 0.0 ? -0.5 : 0.5));
+	}
+
+	static constexpr RGBcoefficients RGBmatrix(double kr, double kb)
+	{
+		return {
+			{ RGBcoef(kr * 219.0/255.0), RGBcoef((1.0-kr-kb) * 219.0/255.0), RGBcoef(kb * 219.0/255.0) },
+			{ RGBcoef(-kr * 112.0/255.0/(1.0-kb)), RGBcoef(-(1.0-kr-kb) * 112.0/255.0/(1.0-kb)), RGBcoef(112.0/255.0) },
+			{ RGBcoef(112.0/255.0), RGBcoef(-(1.0-kr-kb) * 112.0/255.0/(1.0-kr)), RGBcoef(-kb * 112.0/255.0/(1.0-kr)) }
+		};
+	}
+
+	// BT.601, BT.709, BT.2020
+	static constexpr RGBcoefficients RGBcoefs[3] = {
+		RGBmatrix(0.299,  0.114),
+		RGBmatrix(0.2126, 0.0722),
+		RGBmatrix(0.2627, 0.0593)
+	};
+
+	// Rounded offsets for Y (14 bit) and pair averaged U and V (15 bit)
+	static const int YOFFSET  = (16 << 14) + (1 << 13);
+	static const int UVOFFSET = (128 << 15) + (1 << 14);
+
+	// Scalar reference
+	// The last pixel of an odd width uses its own chroma.
+	static void rgba_uyvy_row(const unsigned char* rgba, unsigned char* yuv, unsigned int width, const RGBcoefficients &c)
+	{
+		unsigned int x = 0;
+		for (; x < width; x += 2) {
+			const unsigned char* p0 = rgba;
+			const unsigned char* p1 = (x + 1 < width) ? rgba + 4 : rgba;
+			int r = p0[0] + p1[0];
+			int g = p0[1] + p1[1];
+			int b = p0[2] + p1[2];
+			int y0 = (c.y[0]*p0[0] + c.y[1]*p0[1] + c.y[2]*p0[2] + YOFFSET) >> 14;
+			int y1 = (c.y[0]*p1[0] + c.y[1]*p1[1] + c.y[2]*p1[2] + YOFFSET) >> 14;
+			int u  = (c.u[0]*r + c.u[1]*g + c.u[2]*b + UVOFFSET) >> 15;
+			int v  = (c.v[0]*r + c.v[1]*g + c.v[2]*b + UVOFFSET) >> 15;
+			yuv[0] = clamp8(u);
+			yuv[1] = clamp8(y0);
+			yuv[2] = clamp8(v);
+			yuv[3] = clamp8(y1);
+			rgba += 8;
+			yuv  += 4;
+		}
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	//
+	// SSE2 - 8 pixels per loop
+	//
+	// Each pixel is unpacked to 16 bit r, g, b, a and multiplied
+	// by (r, g, b, 0) coefficients with _mm_madd_epi16.
+	// The two partial sums for each pixel are then added.
+	//
+	static inline __m128i rgba_dot_sse2(__m128i px, __m128i coef)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coef); // px 0-1
+		__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coef); // px 2-3
+		__m128 e = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 o = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+		return _mm_add_epi32(_mm_castps_si128(e), _mm_castps_si128(o)); // 4 x 32 bit
+	}
+
+	// Sum pixel pairs of two sets of 4 values
+	static inline __m128i pair_sum_sse2(__m128i a, __m128i b)
+	{
+		a = _mm_add_epi32(a, _mm_srli_epi64(a, 32));
+		b = _mm_add_epi32(b, _mm_srli_epi64(b, 32));
+		return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	static void rgba_uyvy_row_sse2(const unsigned char* rgba, unsigned char* yuv, unsigned int width, const RGBcoefficients &c)
+	{
+		const __m128i ycoef = _mm_setr_epi16(c.y[0], c.y[1], c.y[2], 0, c.y[0], c.y[1], c.y[2], 0);
+		const __m128i ucoef = _mm_setr_epi16(c.u[0], c.u[1], c.u[2], 0, c.u[0], c.u[1], c.u[2], 0);
+		const __m128i vcoef = _mm_setr_epi16(c.v[0], c.v[1], c.v[2], 0, c.v[0], c.v[1], c.v[2], 0);
+		const __m128i yoff  = _mm_set1_epi32(YOFFSET);
+		const __m128i uvoff = _mm_set1_epi32(UVOFFSET);
+
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba));
+			__m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 16));
+
+			// Y for every pixel
+			__m128i y0 = _mm_srai_epi32(_mm_add_epi32(rgba_dot_sse2(p0, ycoef), yoff), 14);
+			__m128i y1 = _mm_srai_epi32(_mm_add_epi32(rgba_dot_sse2(p1, ycoef), yoff), 14);
+			__m128i y8 = _mm_packs_epi32(y0, y1); // y0-y7
+
+			// U and V from the sum of each pixel pair
+			__m128i u = pair_sum_sse2(rgba_dot_sse2(p0, ucoef), rgba_dot_sse2(p1, ucoef));
+			__m128i v = pair_sum_sse2(rgba_dot_sse2(p0, vcoef), rgba_dot_sse2(p1, vcoef));
+			u = _mm_srai_epi32(_mm_add_epi32(u, uvoff), 15);
+			v = _mm_srai_epi32(_mm_add_epi32(v, uvoff), 15);
+			__m128i uv = _mm_packs_epi32(u, v); // u0-u3, v0-v3
+			uv = _mm_unpacklo_epi16(uv, _mm_srli_si128(uv, 8)); // u0 v0 u1 v1 ...
+
+			// u y v y
+			__m128i lo = _mm_unpacklo_epi16(uv, y8);
+			__m128i hi = _mm_unpackhi_epi16(uv, y8);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(yuv), _mm_packus_epi16(lo, hi));
+
+			rgba += 32;
+			yuv  += 16;
+		}
+
+		if (x < width)
+			rgba_uyvy_row(rgba, yuv, width - x, c);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	//
+	// AVX2 - 16 pixels per loop
+	//
+	// As for SSE2 with each 128 bit lane holding 4 pixels of
+	// each load. The output is re-ordered by 64 bit permute.
+	//
+	OFXNDI_TARGET_AVX2
+	static inline __m256i rgba_dot_avx2(__m256i px, __m256i coef)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(px, zero), coef);
+		__m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(px, zero), coef);
+		__m256 e = _mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 o = _mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), _MM_SHUFFLE(3, 1, 3, 1));
+		return _mm256_add_epi32(_mm256_castps_si256(e), _mm256_castps_si256(o));
+	}
+
+	OFXNDI_TARGET_AVX2
+	static inline __m256i pair_sum_avx2(__m256i a, __m256i b)
+	{
+		a = _mm256_add_epi32(a, _mm256_srli_epi64(a, 32));
+		b = _mm256_add_epi32(b, _mm256_srli_epi64(b, 32));
+		return _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void rgba_uyvy_row_avx2(const unsigned char* rgba, unsigned char* yuv, unsigned int width, const RGBcoefficients &c)
+	{
+		const __m256i ycoef = _mm256_setr_epi16(c.y[0], c.y[1], c.y[2], 0, c.y[0], c.y[1], c.y[2], 0,
+			c.y[0], c.y[1], c.y[2], 0, c.y[0], c.y[1], c.y[2], 0);
+		const __m256i ucoef = _mm256_setr_epi16(c.u[0], c.u[1], c.u[2], 0, c.u[0], c.u[1], c.u[2], 0,
+			c.u[0], c.u[1], c.u[2], 0, c.u[0], c.u[1], c.u[2], 0);
+		const __m256i vcoef = _mm256_setr_epi16(c.v[0], c.v[1], c.v[2], 0, c.v[0], c.v[1], c.v[2], 0,
+			c.v[0], c.v[1], c.v[2], 0, c.v[0], c.v[1], c.v[2], 0);
+		const __m256i yoff  = _mm256_set1_epi32(YOFFSET);
+		const __m256i uvoff = _mm256_set1_epi32(UVOFFSET);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba));      // px 0-3 | 4-7
+			__m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32)); // px 8-11 | 12-15
+
+			__m256i y0 = _mm256_srai_epi32(_mm256_add_epi32(rgba_dot_avx2(p0, ycoef), yoff), 14);
+			__m256i y1 = _mm256_srai_epi32(_mm256_add_epi32(rgba_dot_avx2(p1, ycoef), yoff), 14);
+			__m256i y8 = _mm256_packs_epi32(y0, y1);
+
+			__m256i u = pair_sum_avx2(rgba_dot_avx2(p0, ucoef), rgba_dot_avx2(p1, ucoef));
+			__m256i v = pair_sum_avx2(rgba_dot_avx2(p0, vcoef), rgba_dot_avx2(p1, vcoef));
+			u = _mm256_srai_epi32(_mm256_add_epi32(u, uvoff), 15);
+			v = _mm256_srai_epi32(_mm256_add_epi32(v, uvoff), 15);
+			__m256i uv = _mm256_packs_epi32(u, v);
+			uv = _mm256_unpacklo_epi16(uv, _mm256_srli_si256(uv, 8));
+
+			__m256i lo = _mm256_unpacklo_epi16(uv, y8); // px 0-3 | 4-7
+			__m256i hi = _mm256_unpackhi_epi16(uv, y8); // px 8-11 | 12-15
+			__m256i out = _mm256_packus_epi16(lo, hi);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(yuv), _mm256_permute4x64_epi64(out, _MM_SHUFFLE(3, 1, 2, 0)));
+
+			rgba += 64;
+			yuv  += 32;
+		}
+
+		if (x < width)
+			rgba_uyvy_row_sse2(rgba, yuv, width - x, c);
+	}
+
+#endif // OFXNDI_X86
+
+	//
+	//        RGBA_to_YUV422
+	//
+	// Y for every pixel
+	// U and V averaged for each pixel pair
+	//
+	// RGBA lines to UYVY, and to the UYVA alpha plane if alphadest is not null.
+	// With an alpha mode, each source line is premultiplied or unpremultiplied
+	// into a line buffer for the band, with red and blue swapped, and converted
+	// from there while it is in cache.
+	// RGB source lines (bRGB) are expanded into the line buffer in the same way
+	// and the alpha plane is opaque.
+	static void RGBAtoYUV(const unsigned char* rgbasource, unsigned char* yuvdest, unsigned char* alphadest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		bool bSwapRB, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIalphamode alpha,
+		bool bRGB = false)
+	{
+		void (*alpharow)(const unsigned char*, unsigned char*, unsigned int, bool) = nullptr;
+		if (bRGB)
+			alpharow = Kernels().rgb_rgba;
+		else if (alpha == alpha_premultiply)
+			alpharow = Kernels().premultiply;
+		else if (alpha == alpha_unpremultiply)
+			alpharow = Kernels().unpremultiply;
+
+		// SD BT.601, HD BT.709, UHD BT.2020 for matrix_auto
+		// (as for the sender rgba2yuv shader)
+		// Coefficients in source component order, or rgba from the line buffer
+		RGBcoefficients c = RGBcoefs[AutoMatrix(matrix, width)];
+		if (bSwapRB && !alpharow) {
+			std::swap(c.y[0], c.y[2]);
+			std::swap(c.u[0], c.u[2]);
+			std::swap(c.v[0], c.v[2]);
+		}
+
+		ParallelRows(width, height, sourcePitch, [&](unsigned int y0, unsigned int y1) {
+			std::vector<unsigned char> line(alpharow ? (size_t)width*4 : 0);
+			for (unsigned int y = y0; y < y1; y++) {
+				const unsigned char* rgba = rgbasource;
+				if (bInvert)
+					rgba += (size_t)(height - 1 - y) * sourcePitch;
+				else
+					rgba += (size_t)y * sourcePitch;
+				if (alpharow) {
+					alpharow(rgba, line.data(), width, bSwapRB);
+					rgba = line.data();
+				}
+				Kernels().rgba_uyvy(rgba, yuvdest + (size_t)y * destPitch, width, c);
+				if (alphadest) {
+					if (bRGB)
+						memset(alphadest + (size_t)y * (destPitch/2), 255, width);
+					else
+						Kernels().rgba_alpha(rgba, alphadest + (size_t)y * (destPitch/2), width);
+				}
+			}
+		});
+	}
+
+	// 1920x1080 : 14 msec scalar, 3.0 msec SSE2, 1.5 msec AVX2
+	void RGBA_to_YUV422(const unsigned char* rgbasource, unsigned char* yuvdest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		bool bSwapRB, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix,
+		ofxNDIalphamode alpha)
+	{
+		if (!rgbasource || !yuvdest || width == 0)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = ((width+1)/2)*4;
+
+		RGBAtoYUV(rgbasource, yuvdest, nullptr, width, height, sourcePitch, bSwapRB, bInvert, destPitch, matrix, alpha);
+	} // end RGBA_to_YUV422
+
+	//
+	//        RGB_to_YUV422
+	//
+	// RGB or BGR lines are expanded to RGBA in a line buffer
+	// for each band and converted as for RGBA_to_YUV422,
+	// without an RGBA copy of the frame.
+	//
+	// 1920x1080 : 19 msec scalar, 4.7 msec SSSE3, 2.4 msec AVX2
+	void RGB_to_YUV422(const unsigned char* rgbsource, unsigned char* yuvdest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		bool bSwapRB, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix, bool bAlpha)
+	{
+		if (!rgbsource || !yuvdest || width == 0)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*3;
+		if (destPitch == 0) destPitch = ((width+1)/2)*4;
+
+		RGBAtoYUV(rgbsource, yuvdest, bAlpha ? yuvdest + (size_t)destPitch * height : nullptr, width, height,
+			sourcePitch, bSwapRB, bInvert, destPitch, matrix, alpha_none, true);
+	} // end RGB_to_YUV422
+
+	//
+	//        UYVA
+	//
+	// UYVY followed by an alpha plane.
+	// If the UYVY line pitch is "stride", the alpha plane
+	// starts at stride*height with line pitch stride/2.
+	//
+
+	// Scalar reference
+	static void rgba_alpha_row(const unsigned char* rgba, unsigned char* alpha, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++)
+			alpha[x] = rgba[x*4 + 3];
+	}
+
+	static void alpha_rgba_row(const unsigned char* alpha, unsigned char* rgba, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++)
+			rgba[x*4 + 3] = alpha[x];
+	}
+
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+
+	// SSE2 - 16 pixels per loop
+	static void rgba_alpha_row_sse2(const unsigned char* rgba, unsigned char* alpha, unsigned int width)
+	{
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			const __m128i* src = reinterpret_cast<const __m128i*>(rgba + (size_t)x * 4);
+			__m128i a0 = _mm_srli_epi32(_mm_loadu_si128(src),     24);
+			__m128i a1 = _mm_srli_epi32(_mm_loadu_si128(src + 1), 24);
+			__m128i a2 = _mm_srli_epi32(_mm_loadu_si128(src + 2), 24);
+			__m128i a3 = _mm_srli_epi32(_mm_loadu_si128(src + 3), 24);
+			__m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(alpha + x), a);
+		}
+		if (x < width)
+			rgba_alpha_row(rgba + (size_t)x * 4, alpha + x, width - x);
+	}
+
+	static void alpha_rgba_row_sse2(const unsigned char* alpha, unsigned char* rgba, unsigned int width)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF);
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + x));
+			// Alpha to the high byte of each pixel
+			__m128i lo = _mm_unpacklo_epi8(zero, a);
+			__m128i hi = _mm_unpackhi_epi8(zero, a);
+			__m128i a4[4] = {
+				_mm_unpacklo_epi16(zero, lo), _mm_unpackhi_epi16(zero, lo),
+				_mm_unpacklo_epi16(zero, hi), _mm_unpackhi_epi16(zero, hi)
+			};
+			__m128i* dst = reinterpret_cast<__m128i*>(rgba + (size_t)x * 4);
+			for (int i = 0; i < 4; i++) {
+				__m128i px = _mm_and_si128(_mm_loadu_si128(dst + i), rgbmask);
+				_mm_storeu_si128(dst + i, _mm_or_si128(px, a4[i]));
+			}
+		}
+		if (x < width)
+			alpha_rgba_row(alpha + x, rgba + (size_t)x * 4, width - x);
+	}
+
+#endif // OFXNDI_X86 || OFXNDI_NEON
+
+#if defined(OFXNDI_X86)
+
+	// AVX2 - 32 pixels per loop
+	// Lane-wise packing is re-ordered by a 32 bit permute.
+	OFXNDI_TARGET_AVX2
+	static void rgba_alpha_row_avx2(const unsigned char* rgba, unsigned char* alpha, unsigned int width)
+	{
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			const __m256i* src = reinterpret_cast<const __m256i*>(rgba + (size_t)x * 4);
+			__m256i a0 = _mm256_srli_epi32(_mm256_loadu_si256(src),     24);
+			__m256i a1 = _mm256_srli_epi32(_mm256_loadu_si256(src + 1), 24);
+			__m256i a2 = _mm256_srli_epi32(_mm256_loadu_si256(src + 2), 24);
+			__m256i a3 = _mm256_srli_epi32(_mm256_loadu_si256(src + 3), 24);
+			__m256i a = _mm256_packus_epi16(_mm256_packs_epi32(a0, a1), _mm256_packs_epi32(a2, a3));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(alpha + x), _mm256_permutevar8x32_epi32(a, order));
+		}
+		if (x < width)
+			rgba_alpha_row_sse2(rgba + (size_t)x * 4, alpha + x, width - x);
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void alpha_rgba_row_avx2(const unsigned char* alpha, unsigned char* rgba, unsigned int width)
+	{
+		const __m256i rgbmask = _mm256_set1_epi32(0x00FFFFFF);
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + x));
+			__m256i a0 = _mm256_slli_epi32(_mm256_cvtepu8_epi32(a), 24);
+			__m256i a1 = _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(a, 8)), 24);
+			__m256i* dst = reinterpret_cast<__m256i*>(rgba + (size_t)x * 4);
+			__m256i p0 = _mm256_and_si256(_mm256_loadu_si256(dst),     rgbmask);
+			__m256i p1 = _mm256_and_si256(_mm256_loadu_si256(dst + 1), rgbmask);
+			_mm256_storeu_si256(dst,     _mm256_or_si256(p0, a0));
+			_mm256_storeu_si256(dst + 1, _mm256_or_si256(p1, a1));
+		}
+		if (x < width)
+			alpha_rgba_row_sse2(alpha + x, rgba + (size_t)x * 4, width - x);
+	}
+
+#endif // OFXNDI_X86
+
+	// RGBA or BGRA to UYVA
+	// Alpha is copied to the plane following the UYVY data
+	// in the same pass as the UYVY conversion
+	// 1920x1080 : 14 msec scalar, 4.7 msec SSE2, 2.3 msec AVX2
+	void RGBA_to_UYVA(const unsigned char* rgbasource, unsigned char* uyvadest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		bool bSwapRB, bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix,
+		ofxNDIalphamode alpha)
+	{
+		if (!rgbasource || !uyvadest || width == 0)
+			return;
+
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = ((width+1)/2)*4;
+
+		RGBAtoYUV(rgbasource, uyvadest, uyvadest + (size_t)destPitch * height, width, height,
+			sourcePitch, bSwapRB, bInvert, destPitch, matrix, alpha);
+	}
+
+	// UYVA to RGBA
+	// Alpha is inserted into each line after conversion
+	// and premultiplied or unpremultiplied while the line is still in cache.
+	// 1920x1080 : 14 msec scalar, 4.2 msec SSE2, 1.7 msec AVX2
+	void UYVA_to_RGBA(const unsigned char* uyvasource, unsigned char* rgbadest,
+		unsigned int width, unsigned int height, unsigned int stride, bool bInvert,
+		unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range,
+		ofxNDIalphamode alpha)
+	{
+		if (!uyvasource || !rgbadest || width == 0)
+			return;
+
+		if (destPitch == 0) destPitch = width*4;
+
+		const YUVcoefficients &c = YUVselect(matrix, range, width);
+
+		if (stride == 0) stride = ((width+1)/2)*4;
+		const unsigned char* alphasource = uyvasource + (size_t)stride * height;
+
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				unsigned char* rgba = rgbadest + (size_t)(bInvert ? height - 1 - y : y) * destPitch;
+				Kernels().uyvy_rgba(uyvasource + (size_t)y * stride, rgba, width, c, false);
+				Kernels().alpha_rgba(alphasource + (size_t)y * (stride/2), rgba, width);
+				if (alpha != alpha_none)
+					GradeRow(nullptr, alpha, rgba, width);
+			}
+		});
+	}
+
+	//
+	//        Colour lookup tables
+	//
+	// 1D tables are 256 entries for each channel.
+	//
+	// 3D lattice points are packed as 10 bit red, green and blue
+	// (value*4, 0-1020) so that the four corners of a tetrahedron
+	// are fetched with one AVX2 gather each for 8 pixels.
+	//
+	// Each channel is scaled to the lattice with 8 bit fractions
+	//   t = c*(size-1)*257, index = t >> 16, fraction = (t >> 8) & 255
+	// so that 255 is the far edge of the last cell.
+	//
+	// Tetrahedral interpolation - with the fractions sorted f1 >= f2 >= f3,
+	// the result is weighted by (256-f1), (f1-f2), (f2-f3) and f3
+	// from the cell origin, the corner on the axis of f1, the corner
+	// on the axes of f1 and f2, and the far corner.
+	// If fractions are equal, the weight of the corner that depends
+	// on the order is zero, so the integer result is exact
+	// for all SIMD levels.
+	//
+	// SSE2 has no gather and uses the scalar function.
+	// 1920x1080 33 point, random pixels : 25 msec scalar, 5.8 msec AVX2
+	// 1D tables only : 2.6 msec
+	//
+
+	// 1D tables for a line
+	static void lut1d_row(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++) {
+			dst[0] = lut.table[0][src[0]];
+			dst[1] = lut.table[1][src[1]];
+			dst[2] = lut.table[2][src[2]];
+			dst[3] = src[3];
+			src += 4;
+			dst += 4;
+		}
+	}
+
+	static void lut3d_row(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width)
+	{
+		const unsigned int n  = lut.size;
+		const unsigned int m  = (n - 1) * 257;
+		const unsigned int o3 = 1 + n + n*n;
+		const uint32_t* lattice = lut.lattice.data();
+		for (unsigned int x = 0; x < width; x++) {
+			const unsigned int tr = src[0]*m;
+			const unsigned int tg = src[1]*m;
+			const unsigned int tb = src[2]*m;
+			const unsigned int fr = (tr >> 8) & 255;
+			const unsigned int fg = (tg >> 8) & 255;
+			const unsigned int fb = (tb >> 8) & 255;
+			const uint32_t* c = lattice + (tr >> 16) + (tg >> 16)*n + (tb >> 16)*n*n;
+			const unsigned int f1 = std::max(std::max(fr, fg), fb);
+			const unsigned int f3 = std::min(std::min(fr, fg), fb);
+			const unsigned int f2 = fr + fg + fb - f1 - f3;
+			// Axis of the largest and smallest fraction
+			const unsigned int o1 = (fr == f1) ? 1 : (fg == f1) ? n : n*n;
+			const unsigned int o2 = o3 - ((fr == f3) ? 1 : (fg == f3) ? n : n*n);
+			const uint32_t c0 = c[0], c1 = c[o1], c2 = c[o2], c3 = c[o3];
+			const unsigned int w0 = 256 - f1, w1 = f1 - f2, w2 = f2 - f3, w3 = f3;
+			for (unsigned int i = 0; i < 3; i++) {
+				const unsigned int s = i*10;
+				dst[i] = (unsigned char)((((c0 >> s) & 1023)*w0 + ((c1 >> s) & 1023)*w1
+					+ ((c2 >> s) & 1023)*w2 + ((c3 >> s) & 1023)*w3 + 512) >> 10);
+			}
+			dst[3] = src[3];
+			src += 4;
+			dst += 4;
+		}
+	}
+
+	// Source and destination can be the same
+	static void lut_rgba_row(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width)
+	{
+		if (lut.b1D) {
+			lut1d_row(lut, src, dst, width);
+			src = dst;
+		}
+		if (lut.size >= 2)
+			lut3d_row(lut, src, dst, width);
+	}
+
+#if defined(OFXNDI_X86)
+	// Sum of two channel values with 16 bit weight pairs
+	OFXNDI_TARGET_AVX2
+	static inline __m256i lut_sum_avx2(__m256i c01, __m256i c23, __m256i w01, __m256i w23)
+	{
+		return _mm256_add_epi32(_mm256_madd_epi16(c01, w01), _mm256_madd_epi16(c23, w23));
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void lut3d_row_avx2(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width)
+	{
+		const int n = (int)lut.size;
+		const int* lattice = reinterpret_cast<const int*>(lut.lattice.data());
+		const __m256i mask  = _mm256_set1_epi32(0xFF);
+		const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+		const __m256i lo10  = _mm256_set1_epi32(1023);
+		const __m256i hi10  = _mm256_set1_epi32(1023 << 16);
+		const __m256i scale = _mm256_set1_epi32((n - 1) * 257);
+		const __m256i sx = _mm256_set1_epi32(1);
+		const __m256i sy = _mm256_set1_epi32(n);
+		const __m256i sz = _mm256_set1_epi32(n*n);
+		const __m256i s3 = _mm256_set1_epi32(1 + n + n*n);
+		const __m256i one = _mm256_set1_epi32(256);
+		const __m256i round = _mm256_set1_epi32(512);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x*4));
+			const __m256i tr = _mm256_mullo_epi32(_mm256_and_si256(v, mask), scale);
+			const __m256i tg = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 8), mask), scale);
+			const __m256i tb = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask), scale);
+			const __m256i fr = _mm256_and_si256(_mm256_srli_epi32(tr, 8), mask);
+			const __m256i fg = _mm256_and_si256(_mm256_srli_epi32(tg, 8), mask);
+			const __m256i fb = _mm256_and_si256(_mm256_srli_epi32(tb, 8), mask);
+			const __m256i base = _mm256_add_epi32(_mm256_srli_epi32(tr, 16),
+				_mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(tg, 16), sy),
+					_mm256_mullo_epi32(_mm256_srli_epi32(tb, 16), sz)));
+			const __m256i f1 = _mm256_max_epi32(_mm256_max_epi32(fr, fg), fb);
+			const __m256i f3 = _mm256_min_epi32(_mm256_min_epi32(fr, fg), fb);
+			const __m256i f2 = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_add_epi32(fr, fg), fb), f1), f3);
+			// Axis of the largest and smallest fraction, red first as for the scalar function
+			const __m256i o1 = _mm256_blendv_epi8(_mm256_blendv_epi8(sz, sy, _mm256_cmpeq_epi32(fg, f1)), sx, _mm256_cmpeq_epi32(fr, f1));
+			const __m256i o2 = _mm256_sub_epi32(s3,
+				_mm256_blendv_epi8(_mm256_blendv_epi8(sz, sy, _mm256_cmpeq_epi32(fg, f3)), sx, _mm256_cmpeq_epi32(fr, f3)));
+			const __m256i c0 = _mm256_i32gather_epi32(lattice, base, 4);
+			const __m256i c1 = _mm256_i32gather_epi32(lattice, _mm256_add_epi32(base, o1), 4);
+			const __m256i c2 = _mm256_i32gather_epi32(lattice, _mm256_add_epi32(base, o2), 4);
+			const __m256i c3 = _mm256_i32gather_epi32(lattice, _mm256_add_epi32(base, s3), 4);
+			// Weight pairs for madd
+			const __m256i w01 = _mm256_or_si256(_mm256_sub_epi32(one, f1), _mm256_slli_epi32(_mm256_sub_epi32(f1, f2), 16));
+			const __m256i w23 = _mm256_or_si256(_mm256_sub_epi32(f2, f3), _mm256_slli_epi32(f3, 16));
+			// Channel value pairs in the low and high 16 bits
+			const __m256i r = lut_sum_avx2(
+				_mm256_or_si256(_mm256_and_si256(c0, lo10), _mm256_and_si256(_mm256_slli_epi32(c1, 16), hi10)),
+				_mm256_or_si256(_mm256_and_si256(c2, lo10), _mm256_and_si256(_mm256_slli_epi32(c3, 16), hi10)), w01, w23);
+			const __m256i g = lut_sum_avx2(
+				_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c0, 10), lo10), _mm256_and_si256(_mm256_slli_epi32(c1, 6), hi10)),
+				_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c2, 10), lo10), _mm256_and_si256(_mm256_slli_epi32(c3, 6), hi10)), w01, w23);
+			const __m256i b = lut_sum_avx2(
+				_mm256_or_si256(_mm256_srli_epi32(c0, 20), _mm256_and_si256(_mm256_srli_epi32(c1, 4), hi10)),
+				_mm256_or_si256(_mm256_srli_epi32(c2, 20), _mm256_and_si256(_mm256_srli_epi32(c3, 4), hi10)), w01, w23);
+			__m256i out = _mm256_and_si256(v, alpha);
+			out = _mm256_or_si256(out, _mm256_srli_epi32(_mm256_add_epi32(r, round), 10));
+			out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_srli_epi32(_mm256_add_epi32(g, round), 10), 8));
+			out = _mm256_or_si256(out, _mm256_slli_epi32(_mm256_srli_epi32(_mm256_add_epi32(b, round), 10), 16));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x*4), out);
+		}
+		if (x < width)
+			lut3d_row(lut, src + x*4, dst + x*4, width - x);
+	}
+
+	OFXNDI_TARGET_AVX2
+	static void lut_rgba_row_avx2(const ofxNDIlut &lut, const unsigned char* src, unsigned char* dst, unsigned int width)
+	{
+		if (lut.b1D) {
+			lut1d_row(lut, src, dst, width);
+			src = dst;
+		}
+		if (lut.size >= 2)
+			lut3d_row_avx2(lut, src, dst, width);
+	}
+#endif
+
+	// 1D tables from size entries for the input range dmin to dmax
+	static void LUT1Dresample(ofxNDIlut &lut, const float* rgb, unsigned int size, const float* dmin, const float* dmax)
+	{
+		for (unsigned int c = 0; c < 3; c++) {
+			const float range = (dmax[c] > dmin[c]) ? dmax[c] - dmin[c] : 1.0f;
+			for (unsigned int i = 0; i < 256; i++) {
+				float pos = ((float)i/255.0f - dmin[c]) / range * (float)(size - 1);
+				pos = std::min(std::max(pos, 0.0f), (float)(size - 1));
+				const unsigned int i0 = std::min((unsigned int)pos, size - 2);
+				const float f = pos - (float)i0;
+				const float v = rgb[i0*3 + c] * (1.0f - f) + rgb[(i0 + 1)*3 + c] * f;
+				lut.table[c][i] = (unsigned char)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+			}
+		}
+		lut.b1D = true;
+	}
+
+	bool CreateLUT1D(ofxNDIlut &lut, const float* rgb, unsigned int size)
+	{
+		if (!rgb || size < 2) {
+			printf("CreateLUT1D - size %u is not supported\n", size);
+			return false;
+		}
+		const float dmin[3]{ 0.0f, 0.0f, 0.0f };
+		const float dmax[3]{ 1.0f, 1.0f, 1.0f };
+		LUT1Dresample(lut, rgb, size, dmin, dmax);
+		return true;
+	}
+
+	bool CreateLUT3D(ofxNDIlut &lut, const float* rgb, unsigned int size)
+	{
+		if (!rgb || size < 2 || size > 65) {
+			printf("CreateLUT3D - size %u is not supported (2 - 65)\n", size);
+			return false;
+		}
+		const size_t points = (size_t)size * size * size;
+		lut.lattice.resize(points);
+		for (size_t i = 0; i < points; i++) {
+			uint32_t p = 0;
+			for (unsigned int c = 0; c < 3; c++) {
+				const float v = std::min(std::max(rgb[i*3 + c], 0.0f), 1.0f);
+				p |= (uint32_t)(v * 1020.0f + 0.5f) << (c*10);
+			}
+			lut.lattice[i] = p;
+		}
+		lut.size = size;
+		return true;
+	}
+
+	// Adobe / Resolve .cube format
+	//   TITLE "name"
+	//   LUT_1D_SIZE n, LUT_3D_SIZE n
+	//   DOMAIN_MIN r g b, DOMAIN_MAX r g b
+	//   LUT_1D_INPUT_RANGE min max, LUT_3D_INPUT_RANGE min max
+	//   followed by lines of r g b values, 1D table first
+	// Other keywords are ignored. A 3D domain other than 0 to 1 is not supported.
+	bool LoadCubeLUT(const std::string &path, ofxNDIlut &lut)
+	{
+		std::ifstream file(path);
+		if (!file.is_open()) {
+			printf("LoadCubeLUT - could not open [%s]\n", path.c_str());
+			return false;
+		}
+
+		unsigned int size1 = 0;
+		unsigned int size3 = 0;
+		float dmin1[3]{ 0.0f, 0.0f, 0.0f }, dmax1[3]{ 1.0f, 1.0f, 1.0f };
+		float dmin3[3]{ 0.0f, 0.0f, 0.0f }, dmax3[3]{ 1.0f, 1.0f, 1.0f };
+		std::vector<float> data1;
+		std::vector<float> data3;
+
+		std::string line;
+		unsigned int linenumber = 0;
+		while (std::getline(file, line)) {
+			linenumber++;
+			const size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+			std::istringstream ss(line);
+			std::string key;
+			if (!(ss >> key))
+				continue;
+
+			const char c = key[0];
+			if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.') {
+				// Table entry
+				float rgb[3]{};
+				ss.clear();
+				ss.seekg(0);
+				if (!(ss >> rgb[0] >> rgb[1] >> rgb[2])) {
+					printf("LoadCubeLUT - [%s] line %u is not valid\n", path.c_str(), linenumber);
+					return false;
+				}
+				std::vector<float> &data = (data1.size() < (size_t)size1*3) ? data1 : data3;
+				data.insert(data.end(), rgb, rgb + 3);
+			}
+			else if (key == "LUT_1D_SIZE") {
+				ss >> size1;
+			}
+			else if (key == "LUT_3D_SIZE") {
+				ss >> size3;
 			}
-
-			for (; x + 3 < width; x += 4) {
-				__m128i sourceData = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[x]));
-				// Mask out g and a, which don't change
-				__m128i gaComponents = _mm_andnot_si128(brMask, sourceData);
-				// Mask out b and r
-				__m128i brComponents = _mm_and_si128(sourceData, brMask);
-				// Swap b and r
-				__m128i brSwapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(brComponents, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
-				__m128i result = _mm_or_si128(gaComponents, brSwapped);
-				_mm_store_si128(reinterpret_cast<__m128i*>(&dst[x]), result);
+			else if (key == "DOMAIN_MIN") {
+				ss >> dmin1[0] >> dmin1[1] >> dmin1[2];
+				std::copy(dmin1, dmin1 + 3, dmin3);
+			}
+			else if (key == "DOMAIN_MAX") {
+				ss >> dmax1[0] >> dmax1[1] >> dmax1[2];
+				std::copy(dmax1, dmax1 + 3, dmax3);
+			}
+			else if (key == "LUT_1D_INPUT_RANGE") {
+				ss >> dmin1[0] >> dmax1[0];
+				dmin1[1] = dmin1[2] = dmin1[0];
+				dmax1[1] = dmax1[2] = dmax1[0];
+			}
+			else if (key == "LUT_3D_INPUT_RANGE") {
+				ss >> dmin3[0] >> dmax3[0];
+				dmin3[1] = dmin3[2] = dmin3[0];
+				dmax3[1] = dmax3[2] = dmax3[0];
 			}
+		}
 
-			// Perform leftover writes
-			for (; x < width; x++) {
-				auto rgbapix = src[x];
-#if defined(TARGET_WIN32)
-				// _rotl is available
-				dst[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#else
-				// _rotl replacement
-				dst[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#endif
+		if (size1 == 0 && size3 == 0) {
+			printf("LoadCubeLUT - [%s] has no LUT_1D_SIZE or LUT_3D_SIZE\n", path.c_str());
+			return false;
+		}
+		if (data1.size() != (size_t)size1*3 || data3.size() != (size_t)size3*size3*size3*3) {
+			printf("LoadCubeLUT - [%s] has %u entries for the table size\n", path.c_str(), (unsigned int)((data1.size() + data3.size())/3));
+			return false;
+		}
+		for (unsigned int c = 0; c < 3; c++) {
+			if (size3 > 0 && (dmin3[c] != 0.0f || dmax3[c] != 1.0f)) {
+				printf("LoadCubeLUT - [%s] 3D domain other than 0 to 1 is not supported\n", path.c_str());
+				return false;
 			}
+		}
 
+		ofxNDIlut cube;
+		if (size1 > 0) {
+			if (size1 < 2) {
+				printf("LoadCubeLUT - [%s] LUT_1D_SIZE %u is not supported\n", path.c_str(), size1);
+				return false;
+			}
+			LUT1Dresample(cube, data1.data(), size1, dmin1, dmax1);
 		}
-	} // end rgba_bgra_sse2
+		if (size3 > 0 && !CreateLUT3D(cube, data3.data(), size3))
+			return false;
 
-#endif // endif TARGET_WIN32 || TARGET_OSX
+		lut = std::move(cube);
+		return true;
+	}
 
-	// Without SSE
-	void rgba_bgra(const void *rgba_source, void *bgra_dest,
-		unsigned int width, unsigned int height, bool bInvert)
+	void ApplyLUT(const ofxNDIlut &lut, const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch, bool bInvert)
 	{
+		if (!source || !dest || !LUTused(&lut))
+			return;
 
-		for (unsigned int y = 0; y < height; y++) {
+		if (sourcePitch == 0) sourcePitch = width*4;
+		if (destPitch == 0) destPitch = width*4;
 
-			// Start of buffer
-			auto source = static_cast<const uint32_t*>(rgba_source);; // unsigned int = 4 bytes
-			auto dest = static_cast<uint32_t*>(bgra_dest);
+		ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				Kernels().lut_rgba(lut, source + (size_t)y * sourcePitch,
+					dest + (size_t)(bInvert ? height - 1 - y : y) * destPitch, width);
+			}
+		});
+	}
 
-			// Cast first to avoid warning C26451: Arithmetic overflow
-			unsigned long H1YxW = (unsigned long)((height - 1 - y) * width);
-			unsigned long YxW = (unsigned long)(y * width);
 
-			// Increment to current line
-			if (bInvert) {
-				source += H1YxW;
-				dest += YxW; // dest is not inverted
-			}
-			else {
-				source += YxW;
-				dest += YxW;
-			}
+	//
+	//        ConvertRegion
+	//
+	// Convert a rectangle of a frame to RGBA without converting the whole frame.
+	// Line and plane offsets are calculated from the frame size and stride,
+	// so that only the rectangle is read and converted.
+	//
+	// A rectangle with an odd left edge starts at the second pixel of
+	// a 4:2:2 or 4:2:0 macropixel. That pair is converted to a small
+	// buffer and the remainder of the line from the next macropixel.
+	// Chroma lines for 4:2:0 follow the frame line, not the region line.
+	// The matrix is selected for the frame width (matrix_auto)
+	// and the dither pattern is aligned with the frame,
+	// so the result is the same as a crop of the whole frame.
+	//
+	// A lookup table and alpha conversion are applied to each line
+	// after conversion while it is in cache, so graded output is
+	// one memory pass. Alpha conversion is only for formats with alpha.
+	//
 
-			for (unsigned int x = 0; x < width; x++) {
-				auto rgbapix = source[x];
-#if defined(TARGET_WIN32)
-				// _rotl is available
-				dest[x] = (_rotl(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#else
-				// _rotl replacement
-				dest[x] = (ROL(rgbapix, 16) & 0x00ff00ff) | (rgbapix & 0xff00ff00);
-#endif
-			}
+	// FourCC codes as for the NDI video frame types
+#define OFXNDI_FOURCC(a, b, c, d) ((uint32_t)(uint8_t)(a) | ((uint32_t)(uint8_t)(b) << 8) | ((uint32_t)(uint8_t)(c) << 16) | ((uint32_t)(uint8_t)(d) << 24))
+
+	// UYVY line from pixel "left"
+	static void uyvy_rgba_region(const unsigned char* uyvy, unsigned char* rgba,
+		unsigned int left, unsigned int width, const YUVcoefficients &c)
+	{
+		uyvy += (size_t)(left/2) * 4;
+		if (left & 1)
+			uyvy_rgba_skip(uyvy, rgba, width + 1, c);
+		else
+			Kernels().uyvy_rgba(uyvy, rgba, width, c, false);
+	}
 
+	// P216 line from pixel "left"
+	// The 4 pixel dither row is rotated to the frame column of each call.
+	static void p216_rgba8_region(const uint16_t* y, const uint16_t* uv, const uint16_t* alpha,
+		unsigned char* rgba, unsigned int left, unsigned int width, const P216coefficients &c, const float* dither)
+	{
+		const unsigned int xe = left & ~1u;
+		float d[4]{};
+		if (left & 1) {
+			unsigned char pair[8];
+			for (unsigned int i = 0; i < 4; i++) d[i] = dither[(xe + i) & 3];
+			Kernels().p216_rgba8(y + xe, uv + xe, alpha ? alpha + xe : nullptr, pair, 2, c, d);
+			memcpy(rgba, pair + 4, 4);
+			rgba  += 4;
+			left  += 1;
+			width -= 1;
+			if (width == 0)
+				return;
 		}
+		for (unsigned int i = 0; i < 4; i++) d[i] = dither[(left + i) & 3];
+		Kernels().p216_rgba8(y + left, uv + left, alpha ? alpha + left : nullptr, rgba, width, c, d);
+	}
 
-	} // end rgba_bgra
+	bool ConvertRegion(const unsigned char* source, uint32_t fourcc,
+		unsigned int frameWidth, unsigned int frameHeight, unsigned int stride,
+		unsigned char* dest, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+		bool bInvert, unsigned int destPitch, ofxNDIcolormatrix matrix, ofxNDIcolorrange range, bool bDither,
+		const ofxNDIlut* lut, ofxNDIalphamode alpha)
+	{
+		if (!source || !dest || width == 0 || height == 0)
+			return false;
+		if (x >= frameWidth || y >= frameHeight || width > frameWidth - x || height > frameHeight - y)
+			return false;
 
+		if (destPitch == 0) destPitch = width*4;
+		if (!LUTused(lut)) lut = nullptr;
+
+		switch (fourcc) {
+
+			case OFXNDI_FOURCC('R', 'G', 'B', 'A'):
+			case OFXNDI_FOURCC('R', 'G', 'B', 'X'):
+			case OFXNDI_FOURCC('B', 'G', 'R', 'A'):
+			case OFXNDI_FOURCC('B', 'G', 'R', 'X'):
+			{
+				if (stride == 0) stride = frameWidth*4;
+				const unsigned char* rgbasource = source + (size_t)y * stride + (size_t)x * 4;
+				const bool bSwapRB = (fourcc == OFXNDI_FOURCC('B', 'G', 'R', 'A') || fourcc == OFXNDI_FOURCC('B', 'G', 'R', 'X'));
+				if (fourcc == OFXNDI_FOURCC('R', 'G', 'B', 'X') || fourcc == OFXNDI_FOURCC('B', 'G', 'R', 'X'))
+					alpha = alpha_none;
+				if (!lut) {
+					// Swap, flip and alpha in one pass
+					CopyImage(rgbasource, dest, width, height, stride, destPitch, bInvert, bSwapRB, alpha);
+					return true;
+				}
+				// The table is read from the source, or from the line
+				// after swap or unpremultiply, and premultiplied after
+				ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+					for (unsigned int r = y0; r < y1; r++) {
+						const unsigned char* src = rgbasource + (size_t)r * stride;
+						unsigned char* rgba = dest + (size_t)(bInvert ? height - 1 - r : r) * destPitch;
+						if (alpha == alpha_unpremultiply) {
+							Kernels().unpremultiply(src, rgba, width, bSwapRB);
+							src = rgba;
+						}
+						else if (bSwapRB) {
+							Kernels().rgba_bgra(reinterpret_cast<const uint32_t*>(src), reinterpret_cast<uint32_t*>(rgba), width);
+							src = rgba;
+						}
+						Kernels().lut_rgba(*lut, src, rgba, width);
+						if (alpha == alpha_premultiply)
+							Kernels().premultiply(rgba, rgba, width, false);
+					}
+				});
+				return true;
+			}
 
-	// Flip a buffer in place
-	void FlipBuffer(const unsigned char *src,
-		unsigned char *dst,
-		unsigned int width,
-		unsigned int height)
-	{
-		const unsigned char * From = src;
-		unsigned char * To = dst;
-		unsigned int pitch = width * 4; // RGBA default
-		unsigned int line_s = 0;
-		unsigned int line_t = (height - 1)*pitch;
+			case OFXNDI_FOURCC('U', 'Y', 'V', 'Y'):
+			case OFXNDI_FOURCC('U', 'Y', 'V', 'A'):
+			{
+				if (stride == 0) stride = ((frameWidth+1)/2)*4;
+				const YUVcoefficients &c = YUVselect(matrix, range, frameWidth);
+				// The alpha plane follows the frame with half the UYVY pitch
+				const unsigned char* aplane = (fourcc == OFXNDI_FOURCC('U', 'Y', 'V', 'A'))
+					? source + (size_t)stride * frameHeight + x : nullptr;
+				if (!aplane)
+					alpha = alpha_none;
+				const bool bGrade = (lut || alpha != alpha_none);
+				ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+					for (unsigned int r = y0; r < y1; r++) {
+						unsigned char* rgba = dest + (size_t)(bInvert ? height - 1 - r : r) * destPitch;
+						uyvy_rgba_region(source + (size_t)(y + r) * stride, rgba, x, width, c);
+						if (aplane)
+							Kernels().alpha_rgba(aplane + (size_t)(y + r) * (stride/2), rgba, width);
+						if (bGrade)
+							GradeRow(lut, alpha, rgba, width);
+					}
+				});
+				return true;
+			}
 
-		for (unsigned int y = 0; y < height; y++) {
-			// @zilog no SSE stuff for aarch64 build
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
-			if (width <= 512 || height <= 512) // too small for assembler
-				memcpy((void *)(To + line_t), (void *)(From + line_s), pitch);
-			else if ((pitch % 16) == 0) // use sse assembler function
-				memcpy_sse2((void *)(To + line_t), (void *)(From + line_s), pitch);
-			else if ((pitch % 4) == 0) // use 4 byte move assembler function
-				memcpy_movsd((unsigned long *)(To + line_t), (unsigned long *)(From + line_s), pitch);
-			else
-#endif
-				memcpy((void *)(To + line_t), (void *)(From + line_s), pitch);
+			case OFXNDI_FOURCC('N', 'V', '1', '2'):
+				if (stride == 0) stride = frameWidth;
+				YUV420_to_RGBA(source, stride, source + (size_t)stride * frameHeight, nullptr, stride,
+					dest, destPitch, width, height, bInvert, YUVselect(matrix, range, frameWidth), x, y, lut);
+				return true;
+
+			case OFXNDI_FOURCC('I', '4', '2', '0'):
+			case OFXNDI_FOURCC('Y', 'V', '1', '2'):
+			{
+				if (stride == 0) stride = frameWidth;
+				const unsigned int uvstride = (stride+1)/2;
+				const unsigned char* p1 = source + (size_t)stride * frameHeight;
+				const unsigned char* p2 = p1 + (size_t)uvstride * ((frameHeight+1)/2);
+				const bool bYV12 = (fourcc == OFXNDI_FOURCC('Y', 'V', '1', '2'));
+				YUV420_to_RGBA(source, stride, bYV12 ? p2 : p1, bYV12 ? p1 : p2, uvstride,
+					dest, destPitch, width, height, bInvert, YUVselect(matrix, range, frameWidth), x, y, lut);
+				return true;
+			}
+
+			case OFXNDI_FOURCC('P', '2', '1', '6'):
+			case OFXNDI_FOURCC('P', 'A', '1', '6'):
+			{
+				if (stride == 0) stride = frameWidth*2;
+				const P216coefficients c = P216matrix(matrix, range, frameWidth, 255.0f);
+				const unsigned char* uvplane = source + (size_t)stride * frameHeight;
+				const unsigned char* aplane  = uvplane + (size_t)stride * frameHeight;
+				const bool bAlpha = (fourcc == OFXNDI_FOURCC('P', 'A', '1', '6'));
+				if (!bAlpha)
+					alpha = alpha_none;
+				const bool bGrade = (lut || alpha != alpha_none);
+				ParallelRows(width, height, (size_t)width*4, [&](unsigned int y0, unsigned int y1) {
+					for (unsigned int r = y0; r < y1; r++) {
+						const size_t line = (size_t)(y + r) * stride;
+						unsigned char* rgba = dest + (size_t)(bInvert ? height - 1 - r : r) * destPitch;
+						p216_rgba8_region(reinterpret_cast<const uint16_t*>(source + line),
+							reinterpret_cast<const uint16_t*>(uvplane + line),
+							bAlpha ? reinterpret_cast<const uint16_t*>(aplane + line) : nullptr,
+							rgba, x, width, c, bDither ? DitherMatrix[(y + r) & 3] : NoDither);
+						if (bGrade)
+							GradeRow(lut, alpha, rgba, width);
+					}
+				});
+				return true;
+			}
 
-			line_s += pitch;
-			line_t -= pitch;
+			default:
+				return false;
 		}
-	} // end FlipBuffer
+	} // end ConvertRegion
 
 	//
-	// Flip an image vertically
+	//        Planar tensor
 	//
-	// http://www.codeproject.com/Questions/369873/How-can-i-flip-the-image-Vertically-using-cplusplu
+	// RGBA lines are split to three planes of float32 or float16
+	//   value = byte*scale + bias, scale = 1/(255*std), bias = -mean/std
+	// The plane pointers, scale and bias are given in source byte order,
+	// so that BGRA source and BGR planes need no extra work.
+	//
+	// float16 has only 256 values for each channel. They are rounded
+	// to nearest even once for each call (F16C is not required)
+	// and looked up for each pixel. AVX2 gathers 8 at a time.
+	//
+	// 1920x1080 float32 : 6.2 msec scalar, 2.6 msec SSE2, 2.3 msec AVX2
+	// 1920x1080 float16 : 4.1 msec scalar, 3.0 msec AVX2
 	//
-	bool FlipVertical(unsigned char *inbuf, long widthBytes, long height)
-	{
-		unsigned char *tb1;
-		unsigned char *tb2;
-		long bufsize;
-		long row_cnt;
-		long off1 = 0;
-		long off2 = 0;
-
-		if (inbuf == NULL)
-			return false;
-
-		bufsize = widthBytes * 4;
 
-		tb1 = (unsigned char *)malloc(bufsize);
-		if (tb1 == NULL) {
-			return false;
+	// https://gist.github.com/rygorous/2156668
+	static inline uint16_t float_half(float f)
+	{
+		const uint32_t f16max = (127 + 16) << 23;
+		const uint32_t f32infty = 255u << 23;
+		const uint32_t magicbits = ((127 - 15) + (23 - 10) + 1) << 23;
+		uint32_t u = 0;
+		memcpy(&u, &f, 4);
+		const uint32_t sign = u & 0x80000000u;
+		u ^= sign;
+		uint32_t o = 0;
+		if (u >= f16max) {
+			// Inf or NaN
+			o = (u > f32infty) ? 0x7e00 : 0x7c00;
 		}
-
-		tb2 = (unsigned char *)malloc(bufsize);
-		if (tb2 == NULL) {
-			free((void *)tb1);
-			return false;
+		else if (u < (113u << 23)) {
+			// Denormal or zero - rounded by adding a magic number
+			float magic = 0.0f;
+			memcpy(&magic, &magicbits, 4);
+			float a = 0.0f;
+			memcpy(&a, &u, 4);
+			a += magic;
+			memcpy(&o, &a, 4);
+			o -= magicbits;
 		}
-
-		for (row_cnt = 0; row_cnt < (height + 1) / 2; row_cnt++)
-		{
-			off1 = row_cnt * bufsize;
-			off2 = ((height - 1) - row_cnt)*bufsize;
-			memcpy((void *)tb1, (void *)(inbuf + off1), bufsize * sizeof(unsigned char));
-			memcpy((void *)tb2, (void *)(inbuf + off2), bufsize * sizeof(unsigned char));
-			memcpy((void *)(inbuf + off1), (void *)tb2, bufsize * sizeof(unsigned char));
-			memcpy((void *)(inbuf + off2), (void *)tb1, bufsize * sizeof(unsigned char));
+		else {
+			// Normal - rebias the exponent and round the mantissa
+			const uint32_t mantodd = (u >> 13) & 1;
+			u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+			u += mantodd;
+			o = u >> 13;
 		}
-
-		free((void*)tb1);
-		free((void*)tb2);
-
-		return true;
+		return (uint16_t)(o | (sign >> 16));
 	}
 
-	// ofxNDI version number string
-	// Major, minor, release
-	std::string GetVersion()
+	static void rgba_planar_row(const unsigned char* rgba, float* const* planes, unsigned int width,
+		const float* scale, const float* bias)
 	{
-		return ofxNDIversion;
+		for (unsigned int c = 0; c < 3; c++) {
+			const unsigned char* src = rgba + c;
+			float* dst = planes[c];
+			for (unsigned int x = 0; x < width; x++)
+				dst[x] = (float)src[x*4] * scale[c] + bias[c];
+		}
 	}
 
-	// Copy rgba source image to dest.
-	// Images must be the same size with no line padding.
-	// Option flip image vertically (invert).
-	void CopyImage(const unsigned char *source, unsigned char *dest,
-		unsigned int width, unsigned int height, bool bInvert)
+	// half holds 256 values for each source byte
+	static void rgba_planar16_row(const unsigned char* rgba, uint16_t* const* planes, unsigned int width,
+		const uint16_t* half)
 	{
-		CopyImage(source, dest,	width, height, width*4, false, bInvert);
-
-	} // end CopyImage
+		uint16_t* p0 = planes[0];
+		uint16_t* p1 = planes[1];
+		uint16_t* p2 = planes[2];
+		for (unsigned int x = 0; x < width; x++) {
+			p0[x] = half[rgba[0]];
+			p1[x] = half[256 + rgba[1]];
+			p2[x] = half[512 + rgba[2]];
+			rgba += 4;
+		}
+	}
 
-	// Copy rgba source image to dest.
-	// Source line pitch (unused).
-	// Option convert bgra<>rgba.
-	// Option flip image vertically (invert).
-	void CopyImage(const unsigned char *source, unsigned char *dest,
-		unsigned int width, unsigned int height, unsigned int stride,
-		bool bSwapRB, bool bInvert)
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+	static void rgba_planar_row_sse2(const unsigned char* rgba, float* const* planes, unsigned int width,
+		const float* scale, const float* bias)
 	{
-		if (source == nullptr || dest == nullptr)
-			return;
-
-		// user requires bgra->rgba or rgba->bgra conversion from source to dest
-		if (bSwapRB) {
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
-			rgba_bgra_sse2((const void *)source, (void *)dest, width, height, bInvert);
-#else
-			rgba_bgra((const void *)source, (void *)dest, width, height, bInvert);
-#endif
-			return;
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + x*4));
+			const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + x*4 + 16));
+			for (unsigned int c = 0; c < 3; c++) {
+				const __m128i shift = _mm_cvtsi32_si128((int)c*8);
+				const __m128 s = _mm_set1_ps(scale[c]);
+				const __m128 b = _mm_set1_ps(bias[c]);
+				_mm_storeu_ps(planes[c] + x,
+					_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v0, shift), mask)), s), b));
+				_mm_storeu_ps(planes[c] + x + 4,
+					_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(v1, shift), mask)), s), b));
+			}
 		}
-
-		if (bInvert) { // Flip the image in place
-			FlipBuffer(source, dest, width, height);
+		if (x < width) {
+			float* tail[3] = { planes[0] + x, planes[1] + x, planes[2] + x };
+			rgba_planar_row(rgba + x*4, tail, width - x, scale, bias);
 		}
-		else {
-#if defined(TARGET_WIN32) || defined (TARGET_OSX)
-			// Small image just use memcpy
-			if (width < 512 || height < 256) {
-				memcpy((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
-			}
-			else if ((stride % 16) == 0) { // 16 byte aligned
-				memcpy_sse2((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
+	}
+#endif
+
+#if defined(OFXNDI_X86)
+	OFXNDI_TARGET_AVX2
+	static void rgba_planar_row_avx2(const unsigned char* rgba, float* const* planes, unsigned int width,
+		const float* scale, const float* bias)
+	{
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + x*4));
+			for (unsigned int c = 0; c < 3; c++) {
+				const __m256i bytes = _mm256_and_si256(_mm256_srl_epi32(v, _mm_cvtsi32_si128((int)c*8)), mask);
+				_mm256_storeu_ps(planes[c] + x, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(bytes),
+					_mm256_set1_ps(scale[c])), _mm256_set1_ps(bias[c])));
 			}
-			else if ((stride % 4) == 0) { // 4 byte aligned
-				memcpy_movsd((void*)dest, (const void *)source, (size_t)height* (size_t)stride);
+		}
+		if (x < width) {
+			float* tail[3] = { planes[0] + x, planes[1] + x, planes[2] + x };
+			rgba_planar_row_sse2(rgba + x*4, tail, width - x, scale, bias);
+		}
+	}
+
+	// The gather reads 32 bits at each 16 bit entry.
+	// The table is padded for the last entry.
+	OFXNDI_TARGET_AVX2
+	static void rgba_planar16_row_avx2(const unsigned char* rgba, uint16_t* const* planes, unsigned int width,
+		const uint16_t* half)
+	{
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+		unsigned int x = 0;
+		for (; x + 8 <= width; x += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + x*4));
+			for (unsigned int c = 0; c < 3; c++) {
+				const __m256i bytes = _mm256_and_si256(_mm256_srl_epi32(v, _mm_cvtsi32_si128((int)c*8)), mask);
+				__m256i h = _mm256_i32gather_epi32(reinterpret_cast<const int*>(half + c*256), bytes, 2);
+				// Sign extend for the signed pack
+				h = _mm256_srai_epi32(_mm256_slli_epi32(h, 16), 16);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(planes[c] + x),
+					_mm_packs_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1)));
 			}
-#else
-			// @zilog no SSE stuff for aarch64 build
-			memcpy((void *)dest, (const void *)source, (size_t)height* (size_t)stride);
-#endif
 		}
-	} // end CopyImage
+		if (x < width) {
+			uint16_t* tail[3] = { planes[0] + x, planes[1] + x, planes[2] + x };
+			rgba_planar16_row(rgba + x*4, tail, width - x, half);
+		}
+	}
+#endif
 
+	// Normalization in source byte order and the plane of each source byte
+	struct tensorsetup {
+		float scale[3];
+		float bias[3];
+		uint16_t half[3*256 + 2]; // float16 of each byte value
+		unsigned int plane[3];
+	};
 
-	// Copy rgba image buffers line by line.
-	// Allow for both source and destination line pitch.
-	// Option flip image vertically (invert).
-	void CopyImage(const void* rgba_source, void* rgba_dest,
-		unsigned int width, unsigned int height,
-		unsigned int sourcePitch, unsigned int destPitch,
-		bool bInvert)
+	static void TensorSetup(tensorsetup &t, const ofxNDItensor &tensor, bool bSwapRB)
 	{
-		// For all rows
-		for (unsigned int y = 0; y < height; y++) {
-			// Start of buffers
-			auto source = static_cast<const uint32_t *>(rgba_source); // unsigned int = 4 bytes
-			auto dest = static_cast<uint32_t *>(rgba_dest);
-			// Increment to current line
-			// Pitch is line length in bytes. Divide by 4 to get the width in rgba pixels.
-			if (bInvert) {
-				source += (unsigned long)((height - 1 - y)*sourcePitch / 4);
-				dest   += (unsigned long)(y * destPitch / 4); // dest is not inverted
-			}
-			else {
-				source += (unsigned long)(y * sourcePitch / 4);
-				dest   += (unsigned long)(y * destPitch / 4);
+		for (unsigned int c = 0; c < 3; c++) {
+			// Tensor channel of source byte c (0 red, 1 green, 2 blue)
+			const unsigned int ch = (bSwapRB && c != 1) ? 2 - c : c;
+			const float sd = (tensor.std[ch] != 0.0f) ? tensor.std[ch] : 1.0f;
+			t.scale[c] = 1.0f / (255.0f * sd);
+			t.bias[c] = -tensor.mean[ch] / sd;
+			t.plane[c] = (tensor.bBGR && ch != 1) ? 2 - ch : ch;
+			if (tensor.bHalf) {
+				for (unsigned int i = 0; i < 256; i++)
+					t.half[c*256 + i] = float_half((float)i * t.scale[c] + t.bias[c]);
 			}
+		}
+		t.half[3*256] = t.half[3*256 + 1] = 0;
+	}
 
-			// Copy the line
-			memcpy((void *)dest, (const void *)source, (size_t)width * 4);
+	// Convert a line to the planes at line y
+	static inline void tensor_line(const unsigned char* rgba, void* dest, const tensorsetup &t,
+		unsigned int width, unsigned int height, unsigned int y, unsigned int x, unsigned int n, bool bHalf)
+	{
+		const size_t planesize = (size_t)width * height;
+		const size_t offset = (size_t)y * width + x;
+		if (bHalf) {
+			uint16_t* base = static_cast<uint16_t*>(dest);
+			uint16_t* planes[3];
+			for (unsigned int c = 0; c < 3; c++)
+				planes[c] = base + planesize * t.plane[c] + offset;
+			Kernels().rgba_planar16(rgba, planes, n, t.half);
+		}
+		else {
+			float* base = static_cast<float*>(dest);
+			float* planes[3];
+			for (unsigned int c = 0; c < 3; c++)
+				planes[c] = base + planesize * t.plane[c] + offset;
+			Kernels().rgba_planar(rgba, planes, n, t.scale, t.bias);
 		}
 	}
 
-	// Copy rgb source to rgba dest
-	void rgb2rgba(const void* rgb_source, void* rgba_dest, unsigned int width, unsigned int height, bool bInvert)
+	void RGBA_to_Tensor(const unsigned char* source, void* dest, unsigned int width, unsigned int height,
+		unsigned int sourcePitch, bool bSwapRB, const ofxNDItensor &tensor, bool bInvert)
 	{
-		// Start of buffers
-		auto rgb = static_cast<const unsigned char*>(rgb_source); // rgb/bgr
-		auto rgba = static_cast<unsigned char*>(rgba_dest); // rgba/bgra
-		if (!rgb || !rgba)
+		if (!source || !dest)
 			return;
 
-		const uint64_t rgbsize = (uint64_t)width * (uint64_t)height * 3;
-		const uint64_t rgbpitch = (uint64_t)width * 3;
-		if (bInvert) {
-			rgb += rgbsize; // end of rgb buffer
-			rgb -= rgbpitch; // beginning of the last rgb line
-		}
+		if (sourcePitch == 0) sourcePitch = width*4;
+		tensorsetup t;
+		TensorSetup(t, tensor, bSwapRB);
 
-		for (unsigned int y = 0; y < height; y++) {
-			for (unsigned int x = 0; x < width; x++) {
-				// rgb source - rgba dest
-				*(rgba + 0) = *(rgb + 0); // red
-				*(rgba + 1) = *(rgb + 1); // grn
-				*(rgba + 2) = *(rgb + 2); // blu
-				*(rgba + 3) = (unsigned char)255; // alpha
-				rgb  += 3;
-				rgba += 4;
+		ParallelRows(width, height, (size_t)width*(tensor.bHalf ? 6 : 12), [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++) {
+				tensor_line(source + (size_t)y * sourcePitch, dest, t, width, height,
+					bInvert ? height - 1 - y : y, 0, width, tensor.bHalf);
 			}
-			if (bInvert)
-				rgb -= rgbpitch * 2L; // move up a line for invert
-		}
+		});
+	}
 
-	} // end rgb2rgba
+	// UYVY is converted to an RGBA buffer on the stack
+	// for sections of each line and then to the planes
+	static const unsigned int TENSOR_CHUNK = 512;
 
-	//
-	//        YUV422_to_RGBA
-	//
+	void YUV422_to_Tensor(const unsigned char* source, void* dest, unsigned int width, unsigned int height,
+		unsigned int stride, const ofxNDItensor &tensor, bool bInvert,
+		ofxNDIcolormatrix matrix, ofxNDIcolorrange range)
+	{
+		if (!source || !dest)
+			return;
+
+		if (stride == 0) stride = ((width+1)/2)*4;
+		const YUVcoefficients &c = YUVselect(matrix, range, width);
+		tensorsetup t;
+		TensorSetup(t, tensor, false);
+
+		ParallelRows(width, height, (size_t)width*(tensor.bHalf ? 6 : 12), [&](unsigned int y0, unsigned int y1) {
+			unsigned char rgba[TENSOR_CHUNK*4];
+			for (unsigned int y = y0; y < y1; y++) {
+				const unsigned char* yuv = source + (size_t)y * stride;
+				for (unsigned int x = 0; x < width; x += TENSOR_CHUNK) {
+					const unsigned int n = std::min(width - x, TENSOR_CHUNK);
+					Kernels().uyvy_rgba(yuv + (size_t)(x/2)*4, rgba, n, c, false);
+					tensor_line(rgba, dest, t, width, height, bInvert ? height - 1 - y : y, x, n, tensor.bHalf);
+				}
+			}
+		});
+	}
 
 	//
-	// Lookup tables to avoid repeat calculations
-	//
-	// Initialize once only for repeats
-	static bool tablesInitialized = false;
-	static int YTable[256];
-	static int UToB[256];
-	static int UToG[256];
-	static int VToR[256];
-	static int VToG[256];
-	
-	//
-	// Color space conversion
-	//
-	// https://github.com/rzwm/YUVRGBFormulaGenerator
+	//        Change detection
 	//
-	// BT.601 : 16-235 > 0-255
-	// R = 1.164384(Y - 16) + 1.596027(V - 128)
-	// G = 1.164384(Y - 16) - 0.391762(U - 128) - 0.812968(V - 128)
-	// B = 1.164384(Y - 16) + 2.017232(U - 128)
-	// R = (297(Y - 16) + 407(V - 128) + 127) / 255
-	// G = (297(Y - 16) - 100(U - 128) - 207(V - 128) + 127) / 255
-	// B = (297(Y - 16) + 514(U - 128) + 127) / 255
+	// Each line is read as 64 byte stripes of eight 64 bit words d
+	// added to eight accumulators (after XXH3) :
+	//   acc[i^1] += d[i]
+	//   acc[i]   += lo32(d[i]^key[i]) * hi32(d[i]^key[i])
+	// The key is advanced for each stripe so that moving a block
+	// to another stripe of the line changes the hash.
+	// The last part stripe is padded with zeros and the line
+	// length is included in the final mix.
 	//
-	// BT.709 : 16-235 > 0-255
-	// R = 1.164384(Y - 16) + 1.792741(V - 128)
-	// G = 1.164384(Y - 16) - 0.213249(U - 128) - 0.532909(V - 128)
-	// B = 1.164384(Y - 16) + 2.112402(U - 128)
-	// R = (297(Y - 16) + 457(V - 128) + 127) / 255
-	// G = (297(Y - 16) - 54(U - 128) - 136(V - 128) + 127) / 255
-	// B = (297(Y - 16) + 539(U - 128) + 127) / 255
+	// 1920x1080 rgba : 4.1 msec scalar, 1.7 msec SSE2, 0.6 msec AVX2
 	//
-	static void InitYUVTables(bool bt709)
+	static const uint64_t HashInit[8] = {
+		0x165667B1ull, 0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull,
+		0x85EBCA77C2B2AE63ull, 0x85EBCA77ull, 0x27D4EB2F165667C5ull, 0x9E3779B1ull
+	};
+	static const uint64_t HashKey[8] = {
+		0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull,
+		0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull, 0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull
+	};
+	static const uint64_t HashStep = 0x9E3779B97F4A7C15ull;
+
+	static inline void hash_stripe(uint64_t* acc, uint64_t* key, const unsigned char* src)
 	{
-		for (int i = 0; i < 256; i++) {
+		for (unsigned int i = 0; i < 8; i++) {
+			uint64_t d = 0;
+			memcpy(&d, src + i*8, 8);
+			const uint64_t dk = d ^ key[i];
+			acc[i ^ 1] += d;
+			acc[i] += (dk & 0xFFFFFFFFull) * (dk >> 32);
+			key[i] += HashStep;
+		}
+	}
 
-			int y = i - 16;
-			if (y < 0) y = 0;
-			YTable[i] = 297 * y;
+	// Part stripe and final mix
+	static uint64_t hash_end(uint64_t* acc, uint64_t* key, const unsigned char* src, size_t n, size_t bytes)
+	{
+		if (n > 0) {
+			unsigned char tail[64] = {};
+			memcpy(tail, src, n);
+			hash_stripe(acc, key, tail);
+		}
+		uint64_t h = (uint64_t)bytes * 0x9E3779B185EBCA87ull;
+		for (unsigned int i = 0; i < 8; i++) {
+			h ^= acc[i];
+			h *= 0xC2B2AE3D27D4EB4Full;
+			h ^= h >> 31;
+		}
+		return h;
+	}
 
-			int u = i - 128;
-			int v = i - 128;
+	static uint64_t hash_row(const unsigned char* src, size_t bytes)
+	{
+		uint64_t acc[8];
+		uint64_t key[8];
+		memcpy(acc, HashInit, 64);
+		memcpy(key, HashKey, 64);
+		size_t n = 0;
+		for (; n + 64 <= bytes; n += 64)
+			hash_stripe(acc, key, src + n);
+		return hash_end(acc, key, src + n, bytes - n, bytes);
+	}
 
-			if (bt709) {
-				VToR[i] =  457 * v;
-				VToG[i] = -136 * v;
-				UToG[i] =  -54 * u;
-				UToB[i] =  539 * u;
-			}
-			else {
-				VToR[i] =  407 * v;
-				VToG[i] = -207 * v;
-				UToG[i] = -100 * u;
-				UToB[i] =  514 * u;
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
+	static uint64_t hash_row_sse2(const unsigned char* src, size_t bytes)
+	{
+		__m128i acc[4];
+		__m128i key[4];
+		for (unsigned int j = 0; j < 4; j++) {
+			acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HashInit + j*2));
+			key[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HashKey + j*2));
+		}
+		const __m128i step = _mm_set1_epi64x((long long)HashStep);
+		size_t n = 0;
+		for (; n + 64 <= bytes; n += 64) {
+			for (unsigned int j = 0; j < 4; j++) {
+				const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n + j*16));
+				const __m128i dk = _mm_xor_si128(d, key[j]);
+				acc[j] = _mm_add_epi64(acc[j], _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+				acc[j] = _mm_add_epi64(acc[j], _mm_mul_epu32(dk, _mm_srli_epi64(dk, 32)));
+				key[j] = _mm_add_epi64(key[j], step);
 			}
 		}
+		uint64_t a[8];
+		uint64_t k[8];
+		for (unsigned int j = 0; j < 4; j++) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a + j*2), acc[j]);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(k + j*2), key[j]);
+		}
+		return hash_end(a, k, src + n, bytes - n, bytes);
 	}
+#endif
 
-	// Clamp out of range values 0-255
-	inline unsigned char clamp8(int v) {
-		return (unsigned char)((v & ~255) ? (v < 0 ? 0 : 255) : v);
+#if defined(OFXNDI_X86)
+	OFXNDI_TARGET_AVX2
+	static uint64_t hash_row_avx2(const unsigned char* src, size_t bytes)
+	{
+		__m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(HashInit));
+		__m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(HashInit + 4));
+		__m256i key0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(HashKey));
+		__m256i key1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(HashKey + 4));
+		const __m256i step = _mm256_set1_epi64x((long long)HashStep);
+		size_t n = 0;
+		for (; n + 64 <= bytes; n += 64) {
+			const __m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + n));
+			const __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + n + 32));
+			const __m256i dk0 = _mm256_xor_si256(d0, key0);
+			const __m256i dk1 = _mm256_xor_si256(d1, key1);
+			acc0 = _mm256_add_epi64(acc0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)));
+			acc1 = _mm256_add_epi64(acc1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)));
+			acc0 = _mm256_add_epi64(acc0, _mm256_mul_epu32(dk0, _mm256_srli_epi64(dk0, 32)));
+			acc1 = _mm256_add_epi64(acc1, _mm256_mul_epu32(dk1, _mm256_srli_epi64(dk1, 32)));
+			key0 = _mm256_add_epi64(key0, step);
+			key1 = _mm256_add_epi64(key1, step);
+		}
+		uint64_t a[8];
+		uint64_t k[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(a), acc0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(a + 4), acc1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(k), key0);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(k + 4), key1);
+		return hash_end(a, k, src + n, bytes - n, bytes);
+	}
+#endif
+
+	void HashLines(const unsigned char* source, unsigned int bytes, unsigned int height,
+		unsigned int pitch, uint64_t* hashes)
+	{
+		if (!source || !hashes)
+			return;
+
+		if (pitch == 0) pitch = bytes;
+
+		ParallelRows(bytes/4, height, bytes, [&](unsigned int y0, unsigned int y1) {
+			for (unsigned int y = y0; y < y1; y++)
+				hashes[y] = Kernels().hash_row(source + (size_t)y * pitch, bytes);
+		});
 	}
 
 	//
-	//        YUV422_to_RGBA
-	//
-	// Y sampled at every pixel
-	// U and V sampled at every second pixel 
+	// Buffers
 	//
-	// 5.5 msec
-	void YUV422_to_RGBA(const unsigned char* yuvsource,	unsigned char* rgbadest,
-		unsigned int width, unsigned int height, unsigned int stride)
+
+	static size_t PageSize()
 	{
-		// SD BT.601 for widths <= 720
-		// HD BT.709 default
-		// UHD BT.2020 - use RGBA receiver preference
-		bool b709 = (width > 720);
+#if defined(TARGET_WIN32)
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return (size_t)info.dwPageSize;
+#else
+		const long page = sysconf(_SC_PAGESIZE);
+		return page > 0 ? (size_t)page : 4096;
+#endif
+	}
 
-		if (!tablesInitialized) {
-			InitYUVTables(b709);
-			tablesInitialized = true;
-		}
+	static void FreeBuffer(unsigned char* data, size_t capacity)
+	{
+		if (!data)
+			return;
+#if defined(TARGET_WIN32)
+		(void)capacity;
+		VirtualFree(data, 0, MEM_RELEASE);
+#else
+		munmap(data, capacity);
+#endif
+	}
 
-		// YUV data (NDIlib_FourCC_type_UYVA) is half width 
-		unsigned int w = width/2;
-		if (stride == 0) stride = w*4;
+	unsigned char* ReserveBuffer(ofxNDIbuffer &buffer, size_t size)
+	{
+		buffer.peak = std::max(buffer.peak, size);
+		if (buffer.data && size <= buffer.capacity)
+			return buffer.data;
+
+		// Grow by at least half so that gradual size changes
+		// do not re-allocate each time
+		size_t bytes = std::max(std::max(size, (size_t)1), buffer.capacity + buffer.capacity/2);
+		FreeBuffer(buffer.data, buffer.capacity);
+		buffer.data = nullptr;
+		buffer.capacity = 0;
+		const size_t page = PageSize();
+		unsigned char* data = nullptr;
+
+#if defined(TARGET_WIN32)
+		if (buffer.bHugePages) {
+			// Large pages need the "Lock pages in memory" privilege
+			// and are always resident. Fall back to normal pages if not available.
+			const size_t large = GetLargePageMinimum();
+			if (large > 0) {
+				const size_t largebytes = (bytes + large - 1) / large * large;
+				data = (unsigned char*)VirtualAlloc(nullptr, largebytes,
+					MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+				if (data)
+					bytes = largebytes;
+			}
+		}
+		if (!data) {
+			bytes = (bytes + page - 1) / page * page;
+			data = (unsigned char*)VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		}
+#else
+		size_t align = page;
+#if defined(MADV_HUGEPAGE)
+		// Transparent huge pages need 2MB aligned memory
+		if (buffer.bHugePages)
+			align = 2*1024*1024;
+#endif
+		bytes = (bytes + align - 1) / align * align;
+		const size_t mapped = bytes + align - page;
+		void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p != MAP_FAILED) {
+			// Unmap either side of the aligned range
+			const uintptr_t start = reinterpret_cast<uintptr_t>(p);
+			const uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+			if (aligned > start)
+				munmap(p, aligned - start);
+			if (start + mapped > aligned + bytes)
+				munmap(reinterpret_cast<void*>(aligned + bytes), start + mapped - (aligned + bytes));
+			data = reinterpret_cast<unsigned char*>(aligned);
+#if defined(MADV_HUGEPAGE)
+			if (buffer.bHugePages)
+				madvise(data, bytes, MADV_HUGEPAGE);
+#endif
+		}
+#endif
+		if (!data) {
+			printf("ofxNDIutils::ReserveBuffer - could not allocate %zu bytes\n", bytes);
+			return nullptr;
+		}
 
-		const unsigned char* yuv = yuvsource;
-		unsigned char* rgba = rgbadest;
-		unsigned int padding = stride-w*4;
+		// Fault in the pages now rather than during the first conversion
+		if (buffer.bPrefault) {
+			for (size_t i = 0; i < bytes; i += page)
+				reinterpret_cast<volatile unsigned char*>(data)[i] = 0;
+		}
 
-		for (unsigned int y = 0; y < height; y++) {
-			const unsigned char* rowEnd = yuv + w*4;
-			while (yuv < rowEnd) {
+		buffer.data = data;
+		buffer.capacity = bytes;
+		return data;
+	}
 
-				int u  = *yuv++;
-				int y0 = *yuv++;
-				int v  = *yuv++;
-				int y1 = *yuv++;
+	void ReleaseBuffer(ofxNDIbuffer &buffer)
+	{
+		FreeBuffer(buffer.data, buffer.capacity);
+		buffer.data = nullptr;
+		buffer.capacity = 0;
+		buffer.peak = 0;
+	}
 
-				//
-				// uyvy to rgb with color space conversion
-				//
 
-				// Tables avoid repeat calculations
-				int y0v = YTable[y0];
-				int y1v = YTable[y1];
+	//
+	// SIMD
+	//
 
-				// rgba pixel 1
-				int r = (y0v + VToR[v] + 127) >> 8;
-				int g = (y0v + UToG[u] + VToG[v] + 127) >> 8;
-				int b = (y0v + UToB[u] + 127) >> 8;
+	// Highest SIMD level supported by the CPU
+	ofxNDIsimd GetSIMDsupport()
+	{
+#if defined(OFXNDI_NEON)
+		return simd_neon;
+#elif defined(OFXNDI_X86)
+		bool bSSSE3 = false;
+		bool bAVX2 = false;
+#if defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		const int maxid = info[0];
+		__cpuid(info, 1);
+		bSSSE3 = (info[2] & (1 << 9)) != 0;
+		if (maxid >= 7) {
+			bool bOSXSAVE = (info[2] & (1 << 27)) != 0;
+			bool bAVX     = (info[2] & (1 << 28)) != 0;
+			__cpuidex(info, 7, 0);
+			// The OS must also save the AVX registers
+			if (bOSXSAVE && bAVX && (info[1] & (1 << 5)) != 0)
+				bAVX2 = ((_xgetbv(0) & 6) == 6);
+		}
+#else
+		__builtin_cpu_init();
+		bSSSE3 = __builtin_cpu_supports("ssse3");
+		bAVX2 = __builtin_cpu_supports("avx2");
+#endif
+		if (bAVX2)
+			return simd_avx2;
+		if (bSSSE3)
+			return simd_ssse3;
+		return simd_sse2;
+#else
+		return simd_none;
+#endif
+	}
 
-				*rgba++ = clamp8(r);
-				*rgba++ = clamp8(g);
-				*rgba++ = clamp8(b);
-				*rgba++ = 255;
+	// SIMD level currently used for pixel conversion
+	ofxNDIsimd GetSIMDlevel()
+	{
+		Kernels(); // Select from the CPU features if not set
+		return simdlevel;
+	}
 
-				// rgba pixel 2
-				r = (y1v + VToR[v] + 127) >> 8;
-				g = (y1v + UToG[u] + VToG[v] + 127) >> 8;
-				b = (y1v + UToB[u] + 127) >> 8;
+	// Set the SIMD level used for pixel conversion.
+	// Functions not available for a level use those of the level below.
+	ofxNDIsimd SetSIMDlevel(ofxNDIsimd level)
+	{
+		ofxNDIsimd support = GetSIMDsupport();
+		if (support == simd_neon) {
+			if (level != simd_none)
+				level = simd_neon;
+		}
+		else if (level > support) {
+			level = support;
+		}
 
-				*rgba++ = clamp8(r);
-				*rgba++ = clamp8(g);
-				*rgba++ = clamp8(b);
-				*rgba++ = 255;
-			}
-			yuv += padding; // if any
+		// Scalar reference
+		simdkernels.uyvy_rgba = uyvy_rgba_row;
+		simdkernels.rgba_bgra = rgba_bgra_row;
+		simdkernels.copy      = memcpy_scalar;
+		simdkernels.rgba_uyvy = rgba_uyvy_row;
+		simdkernels.nv12_uyvy = nv12_uyvy_row;
+		simdkernels.i420_uyvy = i420_uyvy_row;
+		simdkernels.p216_rgba16 = p216_rgba16_row;
+		simdkernels.p216_rgba8  = p216_rgba8_row;
+		simdkernels.rgba_alpha  = rgba_alpha_row;
+		simdkernels.alpha_rgba  = alpha_rgba_row;
+		simdkernels.rgb_rgba    = rgb_rgba_row;
+		simdkernels.swap_rows   = swap_rows;
+		simdkernels.vsum_rows   = vsum_rows;
+		simdkernels.lerp_rows   = lerp_rows;
+		simdkernels.uyvy_box_reduce = uyvy_box_reduce;
+		simdkernels.rgba_box_reduce = rgba_box_reduce;
+		simdkernels.box_pack    = box_pack;
+		simdkernels.premultiply   = premultiply_row;
+		simdkernels.unpremultiply = unpremultiply_row;
+		simdkernels.lut_rgba      = lut_rgba_row;
+		simdkernels.rgba_planar   = rgba_planar_row;
+		simdkernels.rgba_planar16 = rgba_planar16_row;
+		simdkernels.hash_row      = hash_row;
+
+#if defined(OFXNDI_X86)
+		if (level >= simd_sse2) {
+			simdkernels.uyvy_rgba = uyvy_rgba_row_sse2;
+			simdkernels.rgba_bgra = rgba_bgra_row_sse2;
+			simdkernels.copy      = memcpy_sse2;
+			simdkernels.rgba_uyvy = rgba_uyvy_row_sse2;
+			simdkernels.nv12_uyvy = nv12_uyvy_row_sse2;
+			simdkernels.i420_uyvy = i420_uyvy_row_sse2;
+			simdkernels.p216_rgba16 = p216_rgba16_row_sse2;
+			simdkernels.p216_rgba8  = p216_rgba8_row_sse2;
+			simdkernels.rgba_alpha  = rgba_alpha_row_sse2;
+			simdkernels.alpha_rgba  = alpha_rgba_row_sse2;
+			simdkernels.swap_rows   = swap_rows_sse2;
+			simdkernels.vsum_rows   = vsum_rows_sse2;
+			simdkernels.lerp_rows   = lerp_rows_sse2;
+			simdkernels.uyvy_box_reduce = uyvy_box_reduce_sse2;
+			simdkernels.rgba_box_reduce = rgba_box_reduce_sse2;
+			simdkernels.box_pack    = box_pack_sse2;
+			simdkernels.premultiply   = premultiply_row_sse2;
+			simdkernels.unpremultiply = unpremultiply_row_sse2;
+			simdkernels.rgba_planar   = rgba_planar_row_sse2;
+			simdkernels.hash_row      = hash_row_sse2;
 		}
-	} // end YUV422_to_RGBA
+		if (level >= simd_ssse3) {
+			simdkernels.rgb_rgba    = rgb_rgba_row_ssse3;
+		}
+		if (level >= simd_avx2) {
+			simdkernels.uyvy_rgba = uyvy_rgba_row_avx2;
+			simdkernels.rgba_bgra = rgba_bgra_row_avx2;
+			simdkernels.copy      = memcpy_avx2;
+			simdkernels.rgba_uyvy = rgba_uyvy_row_avx2;
+			simdkernels.p216_rgba16 = p216_rgba16_row_avx2;
+			simdkernels.p216_rgba8  = p216_rgba8_row_avx2;
+			simdkernels.rgba_alpha  = rgba_alpha_row_avx2;
+			simdkernels.alpha_rgba  = alpha_rgba_row_avx2;
+			simdkernels.premultiply   = premultiply_row_avx2;
+			simdkernels.unpremultiply = unpremultiply_row_avx2;
+			simdkernels.lut_rgba      = lut_rgba_row_avx2;
+			simdkernels.rgba_planar   = rgba_planar_row_avx2;
+			simdkernels.rgba_planar16 = rgba_planar16_row_avx2;
+			simdkernels.hash_row      = hash_row_avx2;
+		}
+#elif defined(OFXNDI_NEON)
+		// Streaming stores have no benefit with sse2neon.
+		// memcpy is retained for copy.
+		if (level == simd_neon) {
+			simdkernels.uyvy_rgba = uyvy_rgba_row_sse2;
+			simdkernels.rgba_bgra = rgba_bgra_row_sse2;
+			simdkernels.rgba_uyvy = rgba_uyvy_row_sse2;
+			simdkernels.nv12_uyvy = nv12_uyvy_row_sse2;
+			simdkernels.i420_uyvy = i420_uyvy_row_sse2;
+			simdkernels.p216_rgba16 = p216_rgba16_row_sse2;
+			simdkernels.p216_rgba8  = p216_rgba8_row_sse2;
+			simdkernels.rgba_alpha  = rgba_alpha_row_sse2;
+			simdkernels.alpha_rgba  = alpha_rgba_row_sse2;
+			simdkernels.rgb_rgba    = rgb_rgba_row_ssse3;
+			simdkernels.swap_rows   = swap_rows_sse2;
+			simdkernels.vsum_rows   = vsum_rows_sse2;
+			simdkernels.lerp_rows   = lerp_rows_sse2;
+			simdkernels.uyvy_box_reduce = uyvy_box_reduce_sse2;
+			simdkernels.rgba_box_reduce = rgba_box_reduce_sse2;
+			simdkernels.box_pack    = box_pack_sse2;
+			simdkernels.premultiply   = premultiply_row_sse2;
+			simdkernels.unpremultiply = unpremultiply_row_sse2;
+			simdkernels.rgba_planar   = rgba_planar_row_sse2;
+			simdkernels.hash_row      = hash_row_sse2;
+		}
+#endif
+
+		simdlevel = level;
+		return simdlevel;
+	}
 
 
 	//
@@ -741,6 +4260,7 @@ namespace ofxNDIutils {
 		}
 	}
 #endif
+#endif // USE_CHRONO
 
 	//
 	// Audio
@@ -1559,7 +5079,9 @@ namespace ofxNDIutils {
 
 #endif // End MessageDialog for Windows
 
-#endif
-
 } // end namespace
 
+ofxNDIbuffer::~ofxNDIbuffer()
+{
+	ofxNDIutils::ReleaseBuffer(*this);
+}
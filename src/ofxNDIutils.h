@@ -35,6 +35,34 @@
 			   std::min/std::max and Windows min/max
 	23.02.26 - Add audio functions AudioFrameSequence and InterleavedToPlanar
 	20-05-26 - Add MessageDialog functions
+	17.10.26 - Add SIMD level functions and ofxNDIsimd enum
+			 - Include SSE intrinsics or sse2neon for Linux
+			 - SSE2 copy functions for all platforms. Add AVX2 functions.
+			 - Add RGBA_to_YUV422 and ofxNDIcolormatrix enum
+			 - Add NV12_to_RGBA and I420_to_RGBA
+			 - Add P216_to_RGBA16 and P216_to_RGBA
+			 - Add RGBA_to_UYVA and UYVA_to_RGBA
+			 - Add SetThreadCount, GetThreadCount, SetThreadMinimum, GetThreadMinimum
+			 - YUV422_to_RGBA - add bInvert, bSwapRB and destPitch
+			 - CopyImage with source and destination pitch - add bSwapRB
+			 - Add ofxNDIcolorrange. YUV to RGBA functions - add matrix and range
+			 - USE_CHRONO for all compilers except Visual Studio before 2015
+			   Audio and MessageDialog functions outside the USE_CHRONO condition
+			 - Source and destination line pitch for all pixel functions
+			 - Add simd_ssse3. rgb2rgba - add bSwapRB
+			 - Add FlipVertical for in-place flip
+			 - Add YUV422_to_RGBA_scaled and ScaleImage
+			 - Add ConvertRegion - convert a rectangle of a frame
+			 - Add ofxNDIalphamode, PremultiplyAlpha, UnpremultiplyAlpha
+			 - Add ofxNDIlut, LoadCubeLUT, CreateLUT1D, CreateLUT3D, ApplyLUT
+			   ConvertRegion - add lut
+			 - Add ofxNDItensor, RGBA_to_Tensor, YUV422_to_Tensor
+			 - Add HashLines for change detection
+			 - Add ofxNDIbuffer, ReserveBuffer, ReleaseBuffer
+			 - UYVA_to_RGBA, P216_to_RGBA, ConvertRegion, ScaleImage - add alpha mode
+			   YUV422_to_RGBA_scaled, ScaleImage - add lut
+			 - RGBA_to_YUV422, RGBA_to_UYVA - add alpha mode
+			 - Add RGB_to_YUV422
 
 */
 #pragma once
@@ -53,6 +81,11 @@
 #include <cmath>     // for std::floor, std::ceil
 #include <algorithm> // for std::min
 #include <numeric>   // for std::accumulate
+#include <thread>    // for conversion threads
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
 
 // TODO : test includes for OSX
 #if defined(TARGET_OSX)
@@ -66,12 +99,25 @@
 #include <windows.h>
 #include <intrin.h> // for _movsd
 #pragma comment (lib, "winmm.lib") // for timeBeginPeriod
-// #else // Linux
+#else // Linux
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include "sse2neon.h"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 #endif
 
 #include <cstring>
 #include <climits>
 
+// SIMD instruction sets available for the build.
+// For ARM, SSE intrinsics are translated to NEON by sse2neon.
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define OFXNDI_NEON
+#elif defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OFXNDI_X86
+#endif
+
 // MessageDialog - windows only
 #if defined(TARGET_WIN32)
 
@@ -97,7 +143,7 @@ processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 // a Visual studio 2017 compiler. "#include <chrono>" will then fail.
 // If this is a problem, remove _MSC_VER_ and manually enable/disable the USE_CHRONO define.
 //
-#if _MSC_VER >= 1900
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
 #define USE_CHRONO
 #endif
 
@@ -114,14 +160,122 @@ enum ofxNDIaudiotype {
 	audio_frame_interleaved_32f_t = 3
 };
 
+// SIMD instruction level for pixel conversion functions
+enum ofxNDIsimd {
+	simd_none  = 0, // Scalar reference functions
+	simd_sse2  = 1,
+	simd_ssse3 = 2, // SSE2 with byte shuffle
+	simd_avx2  = 3,
+	simd_neon  = 4  // ARM - SSE functions translated by sse2neon
+};
+
+// YUV color matrix for RGBA <> YUV conversion
+enum ofxNDIcolormatrix {
+	matrix_auto   = -1, // BT.601 SD, BT.709 HD or BT.2020 UHD depending on width
+	matrix_bt601  = 0,
+	matrix_bt709  = 1,
+	matrix_bt2020 = 2
+};
+
+// YUV range for YUV to RGBA conversion
+enum ofxNDIcolorrange {
+	range_limited = 0, // Y 16-235, U and V 16-240 (default)
+	range_full    = 1  // Y, U and V 0-255
+};
+
+// Alpha conversion for RGBA copy
+enum ofxNDIalphamode {
+	alpha_none          = 0, // Copy unchanged (default)
+	alpha_premultiply   = 1, // Straight to premultiplied
+	alpha_unpremultiply = 2  // Premultiplied to straight
+};
+
+// Colour lookup table for RGBA pixels
+// Per channel 1D tables, a 3D lattice or both (1D first).
+// See ofxNDIutils::LoadCubeLUT, CreateLUT1D and CreateLUT3D.
+struct ofxNDIlut {
+	bool b1D = false; // Per channel tables are used
+	unsigned char table[3][256]{}; // Red, green and blue tables
+	unsigned int size = 0; // 3D lattice points on each axis (0 for none)
+	std::vector<uint32_t> lattice; // 10 bit red, green, blue of each point, red fastest
+};
+
+// Planar tensor output (see ofxNDIutils::RGBA_to_Tensor)
+// Each channel is (value/255 - mean)/std
+struct ofxNDItensor {
+	float mean[3] = { 0.0f, 0.0f, 0.0f }; // Red, green, blue
+	float std[3]  = { 1.0f, 1.0f, 1.0f };
+	bool bHalf = false; // float16 instead of float32
+	bool bBGR = false;  // Blue plane first
+};
+
+// Grow-only conversion buffer (see ofxNDIutils::ReserveBuffer)
+// Page aligned and re-used for any size up to the capacity.
+struct ofxNDIbuffer {
+	unsigned char* data = nullptr;
+	size_t capacity = 0; // Bytes allocated
+	size_t peak = 0; // Largest size requested (high-water mark)
+	bool bHugePages = false; // Use large or transparent huge pages if available
+	bool bPrefault = false; // Touch the pages when allocated rather than on first use
+	ofxNDIbuffer() = default;
+	ofxNDIbuffer(const ofxNDIbuffer &) = delete;
+	ofxNDIbuffer &operator=(const ofxNDIbuffer &) = delete;
+	~ofxNDIbuffer();
+};
+
 namespace ofxNDIutils {
 
 	// ofxNDI version number
 	std::string GetVersion();
 
+	//
+	// SIMD
+	//
+
+	// Highest SIMD level supported by the CPU
+	ofxNDIsimd GetSIMDsupport();
+
+	// SIMD level currently used for pixel conversion.
+	// Selected at startup from the CPU features.
+	ofxNDIsimd GetSIMDlevel();
+
+	// Set the SIMD level used for pixel conversion.
+	// The level is limited to that supported by the CPU.
+	// simd_none selects the scalar reference functions.
+	// Do not change while conversion is in progress on another thread.
+	// Returns the level selected.
+	ofxNDIsimd SetSIMDlevel(ofxNDIsimd level);
+
+	//
+	// Threads
+	//
+	// Pixel conversion functions divide large frames into bands
+	// of lines converted by a pool of worker threads.
+	// The pool is shared by all senders and receivers.
+	//
+
+	// Set the number of threads for pixel conversion, including the caller.
+	// 0 - number of processor cores
+	// 1 - single threaded (default)
+	void SetThreadCount(unsigned int nThreads);
+
+	// Number of threads used for pixel conversion
+	unsigned int GetThreadCount();
+
+	// Frames with fewer pixels are converted single threaded.
+	// Default 1280x720.
+	void SetThreadMinimum(unsigned int pixels);
+
+	// Minimum frame size for multiple threads
+	unsigned int GetThreadMinimum();
+
 	//
 	// Image pixel copy
 	//
+	// Line pitch arguments are in bytes.
+	// Zero selects the pitch of the image width without padding.
+	// Only image pixels are written, so destination padding is unchanged.
+	//
 
 	// Copy rgba source image to dest.
 	// Images must be the same size with no line padding.
@@ -131,7 +285,7 @@ namespace ofxNDIutils {
 		bool bInvert = false);
 
 	// Copy rgba source image to dest.
-	// Source line pitch (unused).
+	// Source line pitch (stride). Destination pitch is width*4.
 	// Option convert bgra<>rgba.
 	// Option flip image vertically (invert).
 	void CopyImage(const unsigned char *source, unsigned char *dest,
@@ -141,22 +295,234 @@ namespace ofxNDIutils {
 	// Copy rgba image buffers line by line.
 	// Allow for both source and destination line pitch.
 	// Option flip image vertically (invert).
+	// Option convert bgra<>rgba in the same pass.
 	void CopyImage(const void* source, void* dest,
 		unsigned int width, unsigned int height,
 		unsigned int sourcePitch, unsigned int destPitch,
-		bool bInvert = false);
+		bool bInvert = false, bool bSwapRB = false);
 
-// TODO : check it works for OSX
-#if defined(TARGET_WIN32) || defined(TARGET_OSX)
+	// SSE2 functions for all platforms
+#if defined(OFXNDI_X86) || defined(OFXNDI_NEON)
 	void memcpy_sse2(void* dst, const void* src, size_t Size);
 	void memcpy_movsd(void* dst, const void* src, size_t Size);
-	void rgba_bgra_sse2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert = false);
+	void rgba_bgra_sse2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert = false,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0);
+#endif
+
+	// AVX2 functions. Check GetSIMDsupport before use.
+#if defined(OFXNDI_X86)
+	void memcpy_avx2(void* dst, const void* src, size_t Size);
+	void rgba_bgra_avx2(const void *source, void *dest, unsigned int width, unsigned int height, bool bInvert = false,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0);
 #endif
 
-	void rgba_bgra(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false);
-	void FlipBuffer(const unsigned char *src, unsigned char *dst, unsigned int width, unsigned int height);
-	void rgb2rgba(const void* rgb_source, void* rgba_dest, unsigned int width, unsigned int height, bool bInvert);
-	void YUV422_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height, unsigned int stride = 0);
+	// rgba <> bgra and flip use the SIMD level selected
+	void rgba_bgra(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0);
+	void FlipBuffer(const unsigned char *src, unsigned char *dst, unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0);
+	// Flip rgba pixels in place. No second buffer is allocated.
+	// pitch is the line pitch in bytes (default width*4)
+	bool FlipVertical(unsigned char *buffer, unsigned int width, unsigned int height, unsigned int pitch = 0);
+	// Premultiply or unpremultiply rgba or bgra pixels by alpha.
+	// Option convert bgra<>rgba and flip in the same pass.
+	// Source and dest can be the same buffer if not inverted.
+	void PremultiplyAlpha(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0,
+		bool bInvert = false, bool bSwapRB = false);
+	void UnpremultiplyAlpha(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0,
+		bool bInvert = false, bool bSwapRB = false);
+	// CopyImage with alpha conversion
+	void CopyImage(const void* rgba_source, void* rgba_dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch, unsigned int destPitch,
+		bool bInvert, bool bSwapRB, ofxNDIalphamode alpha);
+	// Convert RGB or BGR (bSwapRB) to RGBA with alpha 255.
+	// Source pitch default width*3
+	void rgb2rgba(const void* rgb_source, void* rgba_dest, unsigned int width, unsigned int height, bool bInvert,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0, bool bSwapRB = false);
+
+	// Convert UYVY to RGBA or BGRA (bSwapRB).
+	// YUV matrix and range for each call (see ofxNDIcolormatrix, ofxNDIcolorrange).
+	// stride is the UYVY source line pitch in bytes (default (width+1)/2*4)
+	// destPitch is the destination line pitch in bytes (default width*4)
+	// Flip and BGRA output are in the same pass.
+	void YUV422_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height, unsigned int stride = 0,
+		bool bInvert = false, bool bSwapRB = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited);
+
+	// Convert UYVY to RGBA or BGRA (bSwapRB) scaled to destWidth x destHeight in one pass.
+	// Reduction by exactly 2, 4 or 8 averages each block of pixels, other sizes are bilinear.
+	// The matrix is selected for the source width (matrix_auto).
+	// destPitch is the destination line pitch in bytes (default destWidth*4)
+	// Option lookup table applied to each destination line (see ApplyLUT).
+	void YUV422_to_RGBA_scaled(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int stride,
+		unsigned int destWidth, unsigned int destHeight,
+		bool bInvert = false, bool bSwapRB = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited,
+		const ofxNDIlut* lut = nullptr);
+
+	// Scale RGBA or BGRA pixels to destWidth x destHeight
+	// with the same filters as YUV422_to_RGBA_scaled.
+	// Option swap red and blue (bSwapRB) and flip in the same pass.
+	// Option lookup table and alpha conversion of each destination line
+	// with the table after unpremultiply or before premultiply.
+	void ScaleImage(const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height, unsigned int sourcePitch,
+		unsigned int destWidth, unsigned int destHeight,
+		bool bInvert = false, bool bSwapRB = false, unsigned int destPitch = 0,
+		const ofxNDIlut* lut = nullptr, ofxNDIalphamode alpha = alpha_none);
+
+	// Convert NV12 to RGBA.
+	// Y plane followed by interleaved UV at half height with the same pitch.
+	// stride is the Y line pitch in bytes (default width)
+	// destPitch is the destination line pitch in bytes (default width*4)
+	void NV12_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int stride = 0, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited);
+
+	// Convert I420 or YV12 (bYV12) to RGBA.
+	// Y plane followed by U and V planes (V and U for YV12) at half height and half pitch.
+	// stride is the Y line pitch in bytes (default width)
+	// destPitch is the destination line pitch in bytes (default width*4)
+	void I420_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int stride = 0, bool bYV12 = false, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited);
+
+	// Convert P216 or PA16 (bAlpha) to 16 bit RGBA.
+	// Y plane followed by interleaved UV at half width and, for PA16, an alpha plane.
+	// stride is the line pitch in bytes of each plane (default width*2)
+	// destPitch is the destination line pitch in bytes (default width*8, 4 x 16 bit)
+	void P216_to_RGBA16(const unsigned char* source, unsigned short* dest, unsigned int width, unsigned int height,
+		unsigned int stride = 0, bool bAlpha = false, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited);
+
+	// Convert P216 or PA16 (bAlpha) to 8 bit RGBA.
+	// Option 4x4 ordered dither to reduce banding.
+	// destPitch is the destination line pitch in bytes (default width*4)
+	// Option premultiply or unpremultiply PA16 in the same pass.
+	void P216_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int stride = 0, bool bAlpha = false, bool bDither = false, bool bInvert = false,
+		unsigned int destPitch = 0, ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited,
+		ofxNDIalphamode alpha = alpha_none);
+
+	// Convert RGBA or BGRA (bSwapRB) to UYVY.
+	// U and V are averaged for each pixel pair.
+	// sourcePitch is the RGBA line pitch in bytes (default width*4)
+	// destPitch is the UYVY line pitch in bytes (default (width+1)/2*4)
+	// Option premultiply or unpremultiply each source line before conversion.
+	void RGBA_to_YUV422(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, bool bSwapRB = false, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIalphamode alpha = alpha_none);
+
+	// Convert RGB or BGR (bSwapRB) to UYVY, or UYVA with an opaque alpha plane (bAlpha).
+	// Each line is expanded to RGBA in a line buffer and converted as for RGBA_to_YUV422.
+	// sourcePitch is the RGB line pitch in bytes (default width*3)
+	// destPitch is the UYVY line pitch in bytes (default (width+1)/2*4)
+	void RGB_to_YUV422(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, bool bSwapRB = false, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, bool bAlpha = false);
+
+	// Convert RGBA or BGRA (bSwapRB) to UYVA.
+	// UYVY as for RGBA_to_YUV422 followed by the alpha plane.
+	// The alpha plane follows at destPitch*height with half the UYVY pitch.
+	void RGBA_to_UYVA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, bool bSwapRB = false, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIalphamode alpha = alpha_none);
+
+	// Convert UYVA to RGBA.
+	// stride is the UYVY line pitch in bytes (default (width+1)/2*4)
+	// The alpha plane follows at stride*height with pitch stride/2.
+	// destPitch is the destination line pitch in bytes (default width*4)
+	// Option premultiply or unpremultiply in the same pass.
+	void UYVA_to_RGBA(const unsigned char* source, unsigned char* dest, unsigned int width, unsigned int height,
+		unsigned int stride = 0, bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited,
+		ofxNDIalphamode alpha = alpha_none);
+
+	// Convert a rectangle of a frame to RGBA.
+	// fourcc is the frame format as for the NDI video types
+	// (UYVY, UYVA, NV12, I420, YV12, P216, PA16, RGBA, RGBX, BGRA, BGRX).
+	// stride is the frame line pitch in bytes (default for the format and frameWidth)
+	// x, y, width, height is the rectangle within the frame
+	// destPitch is the destination line pitch in bytes (default width*4)
+	// Option lookup table applied to each line as it is converted (see ApplyLUT).
+	// Option premultiply or unpremultiply each line of RGBA, BGRA, UYVA and PA16.
+	// The table is applied after unpremultiply or before premultiply.
+	// Returns false for an unsupported format or a rectangle outside the frame.
+	bool ConvertRegion(const unsigned char* source, uint32_t fourcc,
+		unsigned int frameWidth, unsigned int frameHeight, unsigned int stride,
+		unsigned char* dest, unsigned int x, unsigned int y, unsigned int width, unsigned int height,
+		bool bInvert = false, unsigned int destPitch = 0,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited, bool bDither = false,
+		const ofxNDIlut* lut = nullptr, ofxNDIalphamode alpha = alpha_none);
+
+	//
+	// Colour lookup tables
+	//
+
+	// Load a .cube file with LUT_1D_SIZE, LUT_3D_SIZE or both.
+	// A 3D lattice can have 2 to 65 points on each axis (17, 33, 65 typical).
+	// Returns false if the file could not be read.
+	bool LoadCubeLUT(const std::string &path, ofxNDIlut &lut);
+	// Set the 1D tables from size red, green, blue values from 0 to 1.
+	// The tables are resampled to 256 entries.
+	bool CreateLUT1D(ofxNDIlut &lut, const float* rgb, unsigned int size);
+	// Set the 3D lattice from size*size*size red, green, blue values
+	// from 0 to 1, with red changing fastest as for a .cube file.
+	bool CreateLUT3D(ofxNDIlut &lut, const float* rgb, unsigned int size);
+	// Apply a lookup table to rgba pixels with tetrahedral 3D interpolation.
+	// Alpha is unchanged. Source and dest can be the same buffer if not inverted.
+	void ApplyLUT(const ofxNDIlut &lut, const unsigned char* source, unsigned char* dest,
+		unsigned int width, unsigned int height,
+		unsigned int sourcePitch = 0, unsigned int destPitch = 0, bool bInvert = false);
+
+	//
+	// Planar tensor
+	//
+
+	// Convert RGBA or BGRA (bSwapRB) to planar float32 or float16 (CHW).
+	// dest is three planes of width*height values, red first unless tensor.bBGR.
+	// Alignment of 32 bytes is recommended but not required.
+	// sourcePitch is the source line pitch in bytes (default width*4)
+	void RGBA_to_Tensor(const unsigned char* source, void* dest, unsigned int width, unsigned int height,
+		unsigned int sourcePitch, bool bSwapRB, const ofxNDItensor &tensor, bool bInvert = false);
+
+	// Convert UYVY to planar float32 or float16 as for RGBA_to_Tensor
+	// stride is the UYVY source line pitch in bytes (default (width+1)/2*4)
+	void YUV422_to_Tensor(const unsigned char* source, void* dest, unsigned int width, unsigned int height,
+		unsigned int stride, const ofxNDItensor &tensor, bool bInvert = false,
+		ofxNDIcolormatrix matrix = matrix_auto, ofxNDIcolorrange range = range_limited);
+
+	//
+	// Change detection
+	//
+
+	// 64 bit hash of each line of an image, for any pixel format.
+	// Compare with the hashes of a previous frame to find changed lines.
+	// - bytes | number of bytes of each line hashed (width*4 for rgba)
+	// - pitch | source line pitch in bytes (default bytes)
+	// - hashes | receives height values
+	// The hash is the same for all SIMD levels but is not cryptographic.
+	void HashLines(const unsigned char* source, unsigned int bytes, unsigned int height,
+		unsigned int pitch, uint64_t* hashes);
+
+	//
+	// Buffers
+	//
+
+	// Get a buffer of at least size bytes.
+	// The buffer is only re-allocated if size is more than the capacity,
+	// and then grows by at least half. Contents are not kept.
+	// Returns nullptr if the allocation fails.
+	unsigned char* ReserveBuffer(ofxNDIbuffer &buffer, size_t size);
+
+	// Free the buffer memory and reset the capacity and peak
+	void ReleaseBuffer(ofxNDIbuffer &buffer);
 
 	//
 	// Timing
@@ -173,6 +539,7 @@ namespace ofxNDIutils {
 	// Windows minimum time period
 	void StartTimePeriod();
 	void EndTimePeriod();
+#endif
 #endif
 
 	//
@@ -295,9 +662,6 @@ namespace ofxNDIutils {
 
 #endif // End MessageDialog for Windows
 
-
-#endif
-
 }
 
 